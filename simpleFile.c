@@ -0,0 +1,719 @@
+/*----------------------------------------------------------------------------*/
+/**
+ * @mainpage
+ * <pre>
+ *  Copyright (c) 2014        Southeastern Universities Research Association, *
+ *                            Thomas Jefferson National Accelerator Facility  *
+ *                                                                            *
+ *    This software was developed under a United States Government license    *
+ *    described in the NOTICE file included as part of this distribution.     *
+ *                                                                            *
+ *    Authors: Bryan Moffit                                                   *
+ *             moffit@jlab.org                   Jefferson Lab, MS-12B3       *
+ *             Phone: (757) 269-5660             12000 Jefferson Ave.         *
+ *             Fax:   (757) 269-5800             Newport News, VA 23606       *
+ *                                                                            *
+ *----------------------------------------------------------------------------*
+ *
+ * Description:
+ *     Memory mapped EVIO (version 4) file reader for
+ *      (S)econdary (I)nstance (M)ultiblock (P)rocessing (L)ist (E)xtraction
+ *
+ *     Events are returned as pointers into the mapping, ready for
+ *     simpleScan().  The file is mapped copy-on-write, so events may be
+ *     modified (SIMPLE_SWAP_INPLACE) without touching the file.  Files
+ *     written with the other byte order have each event swapped in place
+ *     the first time it is read.
+ *
+ * </pre>
+ *----------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <byteswap.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "simpleLib.h"
+#include "simpleKernel.h"
+
+/* EVIO version 4 block header */
+#define EVIO_BLOCK_LENGTH        0
+#define EVIO_BLOCK_NUMBER        1
+#define EVIO_BLOCK_HEADER_LENGTH 2
+#define EVIO_BLOCK_EVENT_COUNT   3
+#define EVIO_BLOCK_BITINFO       5
+#define EVIO_BLOCK_MAGIC         7
+#define EVIO_BLOCK_HEADER_WORDS  8
+
+#define EVIO_MAGIC               0xc0da0100
+#define EVIO_VERSION_MASK        0x000000FF
+#define EVIO_DICTIONARY_MASK     (1<<8)
+#define EVIO_LAST_BLOCK_MASK     (1<<9)
+
+/* Words ahead of the reader to ask the kernel to page in */
+#define SIMPLE_FILE_WILLNEED     (1<<20)
+
+typedef struct FileRangeStruct
+{
+  size_t start;
+  size_t end;
+} simpleFileRange;
+
+struct SimpleFileStruct
+{
+  int            fd;
+  unsigned int  *map;
+  size_t         mapSize;	/* bytes */
+  size_t         nwords;	/* whole words in the file */
+  int            swap;		/* File has the other byte order */
+  int            version;
+
+  size_t         block;		/* Index of the current block header */
+  size_t         blockEnd;	/* Index of the word after the current block */
+  int            blockNumber;
+  int            blockEvents;	/* Event count from the block header */
+  int            lastBlock;
+  size_t         next;		/* Index of the next event */
+
+  /* Word ranges [start, end) already swapped to native order, sorted */
+  simpleFileRange *swapped;
+  int            nswapped;
+  int            swappedSize;
+
+  size_t         advised;	/* Words below this index have been advised */
+  unsigned long long nevents;
+};
+
+static inline unsigned int
+simpleFileWord(simpleFile *file, size_t index)
+{
+  unsigned int word = file->map[index];
+  return file->swap ? bswap_32(word) : word;
+}
+
+/* Index of the last swapped range starting at or below index, or -1 */
+static int
+simpleFileFindRange(simpleFile *file, size_t index)
+{
+  int lo = 0, hi = file->nswapped - 1, mid, found = -1;
+
+  while(lo <= hi)
+    {
+      mid = (lo + hi) / 2;
+      if(file->swapped[mid].start <= index)
+	{
+	  found = mid;
+	  lo = mid + 1;
+	}
+      else
+	hi = mid - 1;
+    }
+
+  return found;
+}
+
+static int
+simpleFileIsNative(simpleFile *file, size_t index)
+{
+  int irange;
+
+  /* Reading in order, the event is just past the last range */
+  if((file->nswapped > 0) && (index >= file->swapped[file->nswapped - 1].end))
+    return 0;
+
+  irange = simpleFileFindRange(file, index);
+
+  return ((irange >= 0) && (index < file->swapped[irange].end));
+}
+
+/* Record that the words [start, end) are now in native order */
+static int
+simpleFileAddSwapped(simpleFile *file, size_t start, size_t end)
+{
+  int irange = simpleFileFindRange(file, start);
+  simpleFileRange *r;
+
+  /* Extend the range it follows */
+  if((irange >= 0) && (file->swapped[irange].end == start))
+    {
+      file->swapped[irange].end = end;
+      if((irange + 1 < file->nswapped) && (file->swapped[irange + 1].start == end))
+	{
+	  file->swapped[irange].end = file->swapped[irange + 1].end;
+	  memmove(&file->swapped[irange + 1], &file->swapped[irange + 2],
+		  (file->nswapped - irange - 2) * sizeof(simpleFileRange));
+	  file->nswapped--;
+	}
+      return OK;
+    }
+
+  /* or the range it precedes */
+  if((irange + 1 < file->nswapped) && (file->swapped[irange + 1].start == end))
+    {
+      file->swapped[irange + 1].start = start;
+      return OK;
+    }
+
+  if(file->nswapped == file->swappedSize)
+    {
+      int size = file->swappedSize ? 2 * file->swappedSize : 16;
+      r = (simpleFileRange *) realloc(file->swapped, size * sizeof(simpleFileRange));
+      if(r == NULL)
+	{
+	  printf("%s: ERROR: Unable to allocate swapped ranges\n", __func__);
+	  return ERROR;
+	}
+      file->swapped = r;
+      file->swappedSize = size;
+    }
+
+  irange++;
+  memmove(&file->swapped[irange + 1], &file->swapped[irange],
+	  (file->nswapped - irange) * sizeof(simpleFileRange));
+  file->swapped[irange].start = start;
+  file->swapped[irange].end   = end;
+  file->nswapped++;
+
+  return OK;
+}
+
+/* Swap the ndata words of an EVIO structure of the given type, in place */
+static int
+simpleFileSwapData(unsigned int *data, int ndata, int type)
+{
+  unsigned int header, tmp;
+  int iword = 0, len, ctype, i;
+
+  switch(type)
+    {
+    case EVIO_BANK:
+    case EVIO_ALSOBANK:
+      while(iword + 2 <= ndata)
+	{
+	  data[iword]     = bswap_32(data[iword]);
+	  data[iword + 1] = bswap_32(data[iword + 1]);
+	  len    = data[iword];
+	  header = data[iword + 1];
+	  ctype  = (header >> 8) & 0x3F;
+	  if((len < 1) || (iword + 1 + len > ndata))
+	    return ERROR;
+	  if(simpleFileSwapData(&data[iword + 2], len - 1, ctype) != OK)
+	    return ERROR;
+	  iword += len + 1;
+	}
+      break;
+
+    case EVIO_SEGMENT:
+    case EVIO_ALSOSEGMENT:
+    case EVIO_TAGSEGMENT:
+      while(iword < ndata)
+	{
+	  data[iword] = bswap_32(data[iword]);
+	  header = data[iword];
+	  len    = header & 0xFFFF;
+	  if(type == EVIO_TAGSEGMENT)
+	    ctype = (header >> 16) & 0xF;
+	  else
+	    ctype = (header >> 16) & 0x3F;
+	  if(iword + 1 + len > ndata)
+	    return ERROR;
+	  if(simpleFileSwapData(&data[iword + 1], len, ctype) != OK)
+	    return ERROR;
+	  iword += len + 1;
+	}
+      break;
+
+    case EVIO_DOUBLE64:
+    case EVIO_LONG64:
+    case EVIO_ULONG64:
+      for(i = 0; i + 1 < ndata; i += 2)
+	{
+	  tmp         = bswap_32(data[i]);
+	  data[i]     = bswap_32(data[i + 1]);
+	  data[i + 1] = tmp;
+	}
+      break;
+
+    case EVIO_SHORT16:
+    case EVIO_USHORT16:
+      {
+	unsigned short *d16 = (unsigned short *)data;
+	for(i = 0; i < 2 * ndata; i++)
+	  d16[i] = bswap_16(d16[i]);
+      }
+      break;
+
+    case EVIO_CHARSTAR8:
+    case EVIO_CHAR8:
+    case EVIO_UCHAR8:
+      break;
+
+    default:
+      /* 32 bit data.  Composite data is also swapped as 32 bit words. */
+      simpleKernelGet()->swap32(data, data, ndata);
+    }
+
+  return OK;
+}
+
+/* Read the block header at index, and position the reader at its first event */
+static int
+simpleFileLoadBlock(simpleFile *file, size_t index)
+{
+  unsigned int blkLen, hdrLen, bitinfo;
+
+  if(index + EVIO_BLOCK_HEADER_WORDS > file->nwords)
+    {
+      printf("%s: ERROR: Truncated block header at word %lu\n",
+	     __func__, (unsigned long)index);
+      return ERROR;
+    }
+
+  if(simpleFileWord(file, index + EVIO_BLOCK_MAGIC) != EVIO_MAGIC)
+    {
+      printf("%s: ERROR: Invalid magic word (0x%08x) in block at word %lu\n",
+	     __func__, file->map[index + EVIO_BLOCK_MAGIC], (unsigned long)index);
+      return ERROR;
+    }
+
+  blkLen  = simpleFileWord(file, index + EVIO_BLOCK_LENGTH);
+  hdrLen  = simpleFileWord(file, index + EVIO_BLOCK_HEADER_LENGTH);
+  bitinfo = simpleFileWord(file, index + EVIO_BLOCK_BITINFO);
+
+  if((hdrLen < EVIO_BLOCK_HEADER_WORDS) || (blkLen < hdrLen) ||
+     (index + blkLen > file->nwords))
+    {
+      printf("%s: ERROR: Invalid block (length %u, header length %u) at word %lu\n",
+	     __func__, blkLen, hdrLen, (unsigned long)index);
+      return ERROR;
+    }
+
+  file->block       = index;
+  file->blockEnd    = index + blkLen;
+  file->blockNumber = simpleFileWord(file, index + EVIO_BLOCK_NUMBER);
+  file->blockEvents = simpleFileWord(file, index + EVIO_BLOCK_EVENT_COUNT);
+  file->lastBlock   = (bitinfo & EVIO_LAST_BLOCK_MASK) ? 1 : 0;
+  file->next        = index + hdrLen;
+
+  /* Dictionary is the first event of the first block */
+  if((index == 0) && (bitinfo & EVIO_DICTIONARY_MASK) && (file->next < file->blockEnd))
+    file->next += simpleFileWord(file, file->next) + 1;
+
+  return OK;
+}
+
+/* Ask for the pages ahead of the reader, at the event of len words */
+static void
+simpleFileAdvise(simpleFile *file, size_t len)
+{
+  if(file->next + len > file->advised)
+    {
+      size_t page = sysconf(_SC_PAGESIZE) / 4;
+      size_t start = (file->next / page) * page;
+      size_t end = file->next + len + SIMPLE_FILE_WILLNEED;
+
+      if(end > file->nwords)
+	end = file->nwords;
+      madvise(&file->map[start], (end - start) * 4, MADV_WILLNEED);
+      file->advised = end;
+    }
+}
+
+/* Move to the next block, when the current one is finished */
+static int
+simpleFileNextBlock(simpleFile *file)
+{
+  while(file->next >= file->blockEnd)
+    {
+      if(file->lastBlock || (file->blockEnd >= file->nwords))
+	return SIMPLE_FILE_EOF;
+
+      if(simpleFileLoadBlock(file, file->blockEnd) != OK)
+	return ERROR;
+    }
+
+  return OK;
+}
+
+/**
+ * @ingroup File
+ * @brief Open and memory map an EVIO version 4 file
+ *
+ * @param filename Name of the file
+ *
+ * @return Address of the file handle if successful, otherwise NULL
+ */
+simpleFile *
+simpleFileOpen(const char *filename)
+{
+  simpleFile *file;
+  struct stat st;
+  unsigned int magic, bitinfo;
+
+  file = (simpleFile *) calloc(1, sizeof(simpleFile));
+  if(file == NULL)
+    {
+      printf("%s: ERROR: Unable to allocate file handle\n", __func__);
+      return NULL;
+    }
+
+  file->fd = open(filename, O_RDONLY);
+  if(file->fd < 0)
+    {
+      printf("%s: ERROR: Unable to open %s (%s)\n",
+	     __func__, filename, strerror(errno));
+      free(file);
+      return NULL;
+    }
+
+  if((fstat(file->fd, &st) != 0) || (st.st_size < EVIO_BLOCK_HEADER_WORDS * 4))
+    {
+      printf("%s: ERROR: %s is not an EVIO file\n", __func__, filename);
+      close(file->fd);
+      free(file);
+      return NULL;
+    }
+
+  /* Check the byte order before mapping */
+  if(pread(file->fd, &magic, 4, EVIO_BLOCK_MAGIC * 4) != 4)
+    magic = 0;
+
+  if(magic == EVIO_MAGIC)
+    file->swap = 0;
+  else if(magic == bswap_32(EVIO_MAGIC))
+    file->swap = 1;
+  else
+    {
+      printf("%s: ERROR: %s is not an EVIO file (magic = 0x%08x)\n",
+	     __func__, filename, magic);
+      close(file->fd);
+      free(file);
+      return NULL;
+    }
+
+  file->mapSize = st.st_size;
+  file->nwords  = st.st_size / 4;
+  /* Writable, but private: the other byte order is swapped in the map, and
+     SIMPLE_SWAP_INPLACE rewrites banks in the event.  Neither reaches the file */
+  file->map = (unsigned int *) mmap(NULL, file->mapSize, PROT_READ | PROT_WRITE,
+				    MAP_PRIVATE, file->fd, 0);
+  if(file->map == MAP_FAILED)
+    {
+      printf("%s: ERROR: Unable to map %s (%s)\n",
+	     __func__, filename, strerror(errno));
+      close(file->fd);
+      free(file);
+      return NULL;
+    }
+
+  madvise(file->map, file->mapSize, MADV_SEQUENTIAL);
+
+  bitinfo = simpleFileWord(file, EVIO_BLOCK_BITINFO);
+  file->version = bitinfo & EVIO_VERSION_MASK;
+  if(file->version != 4)
+    {
+      printf("%s: ERROR: %s is EVIO version %d, only version 4 is supported\n",
+	     __func__, filename, file->version);
+      simpleFileClose(file);
+      return NULL;
+    }
+
+  if(simpleFileLoadBlock(file, 0) != OK)
+    {
+      simpleFileClose(file);
+      return NULL;
+    }
+
+  return file;
+}
+
+/**
+ * @ingroup File
+ * @brief Unmap and close a file opened with simpleFileOpen.
+ *    Events from the file may not be used afterwards.
+ *
+ * @param file File handle
+ */
+void
+simpleFileClose(simpleFile *file)
+{
+  if(file == NULL)
+    return;
+
+  if(file->map && (file->map != MAP_FAILED))
+    munmap(file->map, file->mapSize);
+
+  if(file->fd >= 0)
+    close(file->fd);
+
+  if(file->swapped)
+    free(file->swapped);
+
+  free(file);
+}
+
+/**
+ * @ingroup File
+ * @brief Get the next event from the file.
+ *    The event points into the file mapping, and is in native byte order.
+ *    Has the signature of simpleReadFunc, for use with simplePipelineCreate.
+ *
+ * @param arg    File handle (simpleFile *)
+ * @param data   Where to return the address of the event
+ * @param nwords Where to return the length of the event, in words
+ *
+ * @return OK if an event was returned, SIMPLE_FILE_EOF at the end of the file,
+ *         otherwise ERROR
+ */
+int
+simpleFileRead(void *arg, unsigned int **data, int *nwords)
+{
+  simpleFile *file = (simpleFile *)arg;
+  unsigned int *event;
+  size_t len;
+  int swap, status;
+
+  if(file == NULL)
+    {
+      printf("%s: ERROR: NULL file handle\n", __func__);
+      return ERROR;
+    }
+
+  status = simpleFileNextBlock(file);
+  if(status != OK)
+    return status;
+
+  swap = file->swap && !simpleFileIsNative(file, file->next);
+  if(swap)
+    len = (size_t)bswap_32(file->map[file->next]) + 1;
+  else
+    len = (size_t)file->map[file->next] + 1;
+  if(file->next + len > file->blockEnd)
+    {
+      printf("%s: ERROR: Event length (%lu) at word %lu runs past the end of block %d\n",
+	     __func__, (unsigned long)len, (unsigned long)file->next, file->blockNumber);
+      return ERROR;
+    }
+
+  event = &file->map[file->next];
+
+  if(swap)
+    {
+      event[0] = bswap_32(event[0]);
+      if(len > 1)
+	{
+	  event[1] = bswap_32(event[1]);
+	  if(simpleFileSwapData(&event[2], len - 2, (event[1] >> 8) & 0x3F) != OK)
+	    {
+	      printf("%s: ERROR: Invalid structure in event at word %lu\n",
+		     __func__, (unsigned long)file->next);
+	      return ERROR;
+	    }
+	}
+      if(simpleFileAddSwapped(file, file->next, file->next + len) != OK)
+	return ERROR;
+    }
+
+  simpleFileAdvise(file, len);
+
+  *data   = event;
+  *nwords = (int)len;
+
+  file->next += len;
+  file->nevents++;
+
+  return OK;
+}
+
+/**
+ * @ingroup File
+ * @brief Fill the trigger bank columns (event number, timestamp, event type)
+ *    of the events of the next physics events of the file, up to cols->max.
+ *    Only the trigger banks are read: the events are not swapped or scanned,
+ *    and a trigger bank in the other byte order is swapped as it is copied.
+ *    Other events are skipped.  Call again for the events that follow.
+ *
+ * @param file     File handle
+ * @param *cols    Arrays to fill from entry 0.  Any may be NULL, to skip that column.
+ * @param nevents  Where to store the number of events filled
+ *
+ * @return OK if any events were filled, SIMPLE_FILE_EOF at the end of the file,
+ *         otherwise ERROR
+ */
+int
+simpleFileReadTriggerColumns(simpleFile *file, simpleTriggerColumns *cols, int *nevents)
+{
+  unsigned int *event, header;
+  size_t len;
+  int swap, status, nblock, n = 0;
+
+  if((file == NULL) || (cols == NULL))
+    {
+      printf("%s: ERROR: NULL file handle or columns\n", __func__);
+      return ERROR;
+    }
+
+  *nevents = 0;
+
+  while((status = simpleFileNextBlock(file)) == OK)
+    {
+      event = &file->map[file->next];
+      swap = file->swap && !simpleFileIsNative(file, file->next);
+
+      len = (size_t)(swap ? bswap_32(event[0]) : event[0]) + 1;
+      if(file->next + len > file->blockEnd)
+	{
+	  printf("%s: ERROR: Event length (%lu) at word %lu runs past the end of block %d\n",
+		 __func__, (unsigned long)len, (unsigned long)file->next, file->blockNumber);
+	  return ERROR;
+	}
+
+      header = (len > 1) ? (swap ? bswap_32(event[1]) : event[1]) : 0;
+
+      /* Physics events */
+      if(((header >> 16) >= 0xFF50) && ((header >> 16) <= 0xFF8F) && (len > 3))
+	{
+	  nblock = header & 0xFF;
+	  if(n + nblock > cols->max)
+	    {
+	      if(n == 0)
+		{
+		  printf("%s: ERROR: %d events do not fit in %d\n",
+			 __func__, nblock, cols->max);
+		  return ERROR;
+		}
+	      break;
+	    }
+
+	  if((size_t)(swap ? bswap_32(event[2]) : event[2]) + 3 > len)
+	    {
+	      printf("%s: ERROR: Trigger bank runs past the end of the event at word %lu\n",
+		     __func__, (unsigned long)file->next);
+	      return ERROR;
+	    }
+
+	  simpleFileAdvise(file, len);
+	  if(simpleTriggerBankColumns(&event[2], nblock, swap, cols, n) == ERROR)
+	    return ERROR;
+	  n += nblock;
+	}
+
+      file->next += len;
+      file->nevents++;
+    }
+
+  if(status == ERROR)
+    return ERROR;
+
+  *nevents = n;
+
+  return ((n > 0) || (status == OK)) ? OK : SIMPLE_FILE_EOF;
+}
+
+/**
+ * @ingroup File
+ * @brief Go back to the first event of the file
+ *
+ * @param file File handle
+ *
+ * @return OK if successful, otherwise ERROR
+ */
+int
+simpleFileRewind(simpleFile *file)
+{
+  if(file == NULL)
+    {
+      printf("%s: ERROR: NULL file handle\n", __func__);
+      return ERROR;
+    }
+
+  file->nevents = 0;
+  return simpleFileLoadBlock(file, 0);
+}
+
+/**
+ * @ingroup File
+ * @brief Get the position of the next event returned by simpleFileRead.
+ *
+ * @param file   File handle
+ * @param block  Where to store the word offset of its EVIO block header
+ * @param event  Where to store the word offset of the event
+ *
+ * @return OK if successful, SIMPLE_FILE_EOF at the end of the file, otherwise ERROR
+ */
+int
+simpleFileTell(simpleFile *file, unsigned long long *block, unsigned long long *event)
+{
+  int status;
+
+  if(file == NULL)
+    {
+      printf("%s: ERROR: NULL file handle\n", __func__);
+      return ERROR;
+    }
+
+  status = simpleFileNextBlock(file);
+  if(status != OK)
+    return status;
+
+  *block = file->block;
+  *event = file->next;
+
+  return OK;
+}
+
+/**
+ * @ingroup File
+ * @brief Position the reader at an event, from simpleFileTell.
+ *
+ * @param file   File handle
+ * @param block  Word offset of the EVIO block header
+ * @param event  Word offset of the event, inside that block
+ *
+ * @return OK if successful, otherwise ERROR
+ */
+int
+simpleFileSeek(simpleFile *file, unsigned long long block, unsigned long long event)
+{
+  if(file == NULL)
+    {
+      printf("%s: ERROR: NULL file handle\n", __func__);
+      return ERROR;
+    }
+
+  if(simpleFileLoadBlock(file, block) != OK)
+    return ERROR;
+
+  if((event < file->next) || (event >= file->blockEnd))
+    {
+      printf("%s: ERROR: Event offset %llu is outside block at %llu\n",
+	     __func__, event, block);
+      return ERROR;
+    }
+
+  file->next = event;
+
+  return OK;
+}
+
+/**
+ * @ingroup File
+ * @brief Get the byte order of the file
+ *
+ * @param file File handle
+ *
+ * @return 1 if the file has the other byte order (and its events are swapped),
+ *         0 if not, otherwise ERROR
+ */
+int
+simpleFileIsSwapped(simpleFile *file)
+{
+  if(file == NULL)
+    return ERROR;
+
+  return file->swap;
+}
@@ -0,0 +1,763 @@
+/*----------------------------------------------------------------------------*/
+/**
+ * @mainpage
+ * <pre>
+ *  Copyright (c) 2014        Southeastern Universities Research Association, *
+ *                            Thomas Jefferson National Accelerator Facility  *
+ *                                                                            *
+ *    This software was developed under a United States Government license    *
+ *    described in the NOTICE file included as part of this distribution.     *
+ *                                                                            *
+ *    Authors: Bryan Moffit                                                   *
+ *             moffit@jlab.org                   Jefferson Lab, MS-12B3       *
+ *             Phone: (757) 269-5660             12000 Jefferson Ave.         *
+ *             Fax:   (757) 269-5800             Newport News, VA 23606       *
+ *                                                                            *
+ *----------------------------------------------------------------------------*
+ *
+ * Description:
+ *     Persistent (sidecar) index of an EVIO file for
+ *      (S)econdary (I)nstance (M)ultiblock (P)rocessing (L)ist (E)xtraction
+ *
+ *     simpleIndexBuild() scans every physics event of a file once, and
+ *     writes what simpleScan() found to an index file: the file offset
+ *     of each CODA event (block of triggers), its trigger event numbers
+ *     and types, and the offset and length of each ROC/bank/slot event.
+ *     simpleIndexOpen() maps that index, to find an event by trigger
+ *     event number in O(log n) and read it without rescanning the file.
+ *
+ * </pre>
+ *----------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "simpleLib.h"
+#include "simpleKernel.h"
+
+#define SIMPLE_INDEX_MAGIC    0x58444953	/* "SIDX" */
+#define SIMPLE_INDEX_VERSION  2
+#define SIMPLE_INDEX_SUFFIX   ".idx"
+
+/* Index file layout.  Written in native byte order, read back with mmap. */
+typedef struct IndexHeaderStruct
+{
+  unsigned int       magic;
+  unsigned int       version;
+  unsigned long long dataSize;	/* Bytes in the indexed data file */
+  unsigned long long nblocks;	/* CODA events */
+  unsigned long long nslots;	/* Slot event records */
+  unsigned long long ntypes;	/* Event types */
+  unsigned long long slotOffset;	/* Byte offsets of each table in the index file */
+  unsigned long long typeOffset;
+  unsigned long long blockOffset;
+  unsigned long long keyOffset;
+} simpleIndexHeader;
+
+typedef struct IndexBlockStruct
+{
+  unsigned long long fileBlock;	/* Word offset of the EVIO block header */
+  unsigned long long fileEvent;	/* Word offset of the CODA event */
+  unsigned long long firstEvent;	/* Trigger event number of its first event */
+  unsigned long long typeIndex;	/* First of its nevents event types */
+  unsigned long long slotIndex;	/* First of its nslots slot event records */
+  unsigned int       nwords;
+  unsigned int       nevents;
+  unsigned int       nslots;
+  unsigned int       pad;
+} simpleIndexBlock;
+
+/* Sorted by rocID, bankID, slot, evt within each block */
+typedef struct IndexSlotStruct
+{
+  unsigned short rocID;
+  unsigned short bankID;
+  unsigned char  slot;
+  unsigned char  swap;	/* Big endian bank, swapped by the scan */
+  unsigned short evt;
+  unsigned int   offset;	/* Words from the start of the CODA event */
+  unsigned int   length;
+} simpleIndexSlot;
+
+/* Blocks sorted by first event number */
+typedef struct IndexKeyStruct
+{
+  unsigned long long firstEvent;
+  unsigned long long block;
+} simpleIndexKey;
+
+struct SimpleIndexStruct
+{
+  simpleFile              *file;
+  void                    *map;
+  size_t                   mapSize;
+  const simpleIndexHeader *header;
+  const simpleIndexBlock  *block;
+  const simpleIndexSlot   *slot;
+  const unsigned short    *type;
+  const simpleIndexKey    *key;
+  unsigned int            *swapBuffer;	/* Slot event swapped to native order */
+  size_t                   swapSize;
+};
+
+static void
+simpleIndexName(const char *filename, const char *indexname, char *name, size_t size)
+{
+  if(indexname)
+    snprintf(name, size, "%s", indexname);
+  else
+    snprintf(name, size, "%s%s", filename, SIMPLE_INDEX_SUFFIX);
+}
+
+static int
+simpleIndexSlotCompare(const void *a, const void *b)
+{
+  const simpleIndexSlot *sa = (const simpleIndexSlot *)a;
+  const simpleIndexSlot *sb = (const simpleIndexSlot *)b;
+
+  if(sa->rocID != sb->rocID)
+    return (sa->rocID < sb->rocID) ? -1 : 1;
+  if(sa->bankID != sb->bankID)
+    return (sa->bankID < sb->bankID) ? -1 : 1;
+  if(sa->slot != sb->slot)
+    return (sa->slot < sb->slot) ? -1 : 1;
+  if(sa->evt != sb->evt)
+    return (sa->evt < sb->evt) ? -1 : 1;
+  return 0;
+}
+
+static int
+simpleIndexKeyCompare(const void *a, const void *b)
+{
+  const simpleIndexKey *ka = (const simpleIndexKey *)a;
+  const simpleIndexKey *kb = (const simpleIndexKey *)b;
+
+  if(ka->firstEvent != kb->firstEvent)
+    return (ka->firstEvent < kb->firstEvent) ? -1 : 1;
+  return (ka->block < kb->block) ? -1 : (ka->block > kb->block);
+}
+
+/* Grow an array to hold at least n elements */
+static int
+simpleIndexGrow(void **array, size_t *size, size_t n, size_t elsize)
+{
+  size_t newsize;
+  void *a;
+
+  if(n <= *size)
+    return OK;
+
+  newsize = *size ? *size : 1024;
+  while(newsize < n)
+    newsize *= 2;
+
+  a = realloc(*array, newsize * elsize);
+  if(a == NULL)
+    {
+      printf("%s: ERROR: Unable to allocate %lu elements\n",
+	     __func__, (unsigned long)newsize);
+      return ERROR;
+    }
+
+  *array = a;
+  *size  = newsize;
+
+  return OK;
+}
+
+/* Record the slot events indexed by ctx for one CODA event */
+static int
+simpleIndexAddSlots(simpleCtx *ctx, unsigned int *data, int nwords,
+		    simpleIndexSlot **slot, size_t *slotSize, size_t *nslots)
+{
+  int rocList[SIMPLE_MAX_ROCS], bankList[SIMPLE_MAX_BANKS];
+  int nrocs, nbanks, iroc, ibank, islot, ievt, blockLevel, swapMode, len;
+  unsigned int slotmask, *buf;
+
+  nrocs = simpleCtxGetRocList(ctx, rocList);
+  for(iroc = 0; iroc < nrocs; iroc++)
+    {
+      nbanks = simpleCtxGetBankList(ctx, rocList[iroc], bankList);
+      for(ibank = 0; ibank < nbanks; ibank++)
+	{
+	  if((simpleCtxGetRocSlotmask(ctx, rocList[iroc], bankList[ibank], &slotmask) < 0) ||
+	     (simpleCtxGetRocBlockLevel(ctx, rocList[iroc], bankList[ibank], &blockLevel) < 0) ||
+	     (simpleCtxGetRocBankSwap(ctx, rocList[iroc], bankList[ibank], &swapMode) < 0))
+	    continue;
+
+	  for(islot = 0; islot < SIMPLE_MAX_SLOTS; islot++)
+	    {
+	      if((slotmask & (1u << islot)) == 0)
+		continue;
+
+	      if(simpleIndexGrow((void **)slot, slotSize, *nslots + blockLevel,
+				 sizeof(simpleIndexSlot)) != OK)
+		return ERROR;
+
+	      for(ievt = 0; ievt < blockLevel; ievt++)
+		{
+		  simpleIndexSlot *s = &(*slot)[*nslots];
+
+		  len = simpleCtxGetSlotEventData(ctx, rocList[iroc], bankList[ibank],
+						  islot, ievt, &buf);
+		  /* Only events inside the CODA event (not in a swap buffer) */
+		  if((len < 0) || (buf < data) || (buf + len > data + nwords))
+		    continue;
+
+		  s->rocID  = rocList[iroc];
+		  s->bankID = bankList[ibank];
+		  s->slot   = islot;
+		  s->swap   = (swapMode != SIMPLE_SWAP_NONE);
+		  s->evt    = ievt;
+		  s->offset = buf - data;
+		  s->length = len;
+		  (*nslots)++;
+		}
+	    }
+	}
+    }
+
+  return OK;
+}
+
+/**
+ * @ingroup Index
+ * @brief Scan every physics event of an EVIO file, and write an index
+ *    of it for simpleIndexOpen.  Banks are indexed as configured with
+ *    simpleConfigBank.
+ *
+ * @param filename   EVIO file
+ * @param indexname  Index file to write.  If NULL, filename with ".idx" appended.
+ *
+ * @return Number of CODA events indexed if successful, otherwise ERROR
+ */
+int
+simpleIndexBuild(const char *filename, const char *indexname)
+{
+  char name[4096];
+  simpleFile *file = NULL;
+  simpleCtx *ctx = NULL;
+  FILE *out = NULL;
+  struct stat st;
+  simpleIndexHeader header;
+  simpleIndexBlock *block = NULL;
+  simpleIndexSlot *slot = NULL;
+  simpleIndexKey *key = NULL;
+  unsigned short *type = NULL;
+  size_t nblocks = 0, blockSize = 0, nslots = 0, slotSize = 0;
+  size_t ntypes = 0, typeSize = 0, blockSlots = 0;
+  unsigned long long fileBlock, fileEvent, ntriggers = 0;
+  unsigned int *data;
+  unsigned long long *time;
+  unsigned short *evtype;
+  int nwords, status, nevents, ievt, len, rval = ERROR;
+  size_t iblock;
+
+  simpleIndexName(filename, indexname, name, sizeof(name));
+
+  if(stat(filename, &st) != 0)
+    {
+      printf("%s: ERROR: Unable to stat %s (%s)\n", __func__, filename, strerror(errno));
+      return ERROR;
+    }
+
+  file = simpleFileOpen(filename);
+  if(file == NULL)
+    return ERROR;
+
+  ctx = simpleCtxCreate();
+  if(ctx == NULL)
+    goto CLEANUP;
+
+  out = fopen(name, "w");
+  if(out == NULL)
+    {
+      printf("%s: ERROR: Unable to open %s (%s)\n", __func__, name, strerror(errno));
+      goto CLEANUP;
+    }
+
+  /* Header is written again at the end */
+  memset(&header, 0, sizeof(header));
+  if(fwrite(&header, sizeof(header), 1, out) != 1)
+    goto WRITE_ERROR;
+
+  while(1)
+    {
+      status = simpleFileTell(file, &fileBlock, &fileEvent);
+      if(status == OK)
+	status = simpleFileRead(file, &data, &nwords);
+      if(status == SIMPLE_FILE_EOF)
+	break;
+      if(status != OK)
+	goto CLEANUP;
+
+      /* Physics events */
+      if(((data[1] >> 16) < 0xFF50) || ((data[1] >> 16) > 0xFF8F))
+	continue;
+
+      if(simpleCtxScan(ctx, data, nwords) != OK)
+	{
+	  printf("%s: ERROR: Unable to scan the event at word %llu\n", __func__, fileEvent);
+	  goto CLEANUP;
+	}
+
+      nevents = data[1] & 0xFF;
+
+      if((simpleIndexGrow((void **)&block, &blockSize, nblocks + 1,
+			  sizeof(simpleIndexBlock)) != OK) ||
+	 (simpleIndexGrow((void **)&type, &typeSize, ntypes + nevents,
+			  sizeof(unsigned short)) != OK))
+	goto CLEANUP;
+
+      block[nblocks].fileBlock = fileBlock;
+      block[nblocks].fileEvent = fileEvent;
+      block[nblocks].nwords    = nwords;
+      block[nblocks].nevents   = nevents;
+      block[nblocks].pad       = 0;
+
+      /* First event number is the first word of the time segment (may be unaligned) */
+      if(simpleCtxGetTriggerBankTimeSegment(ctx, &time) > 0)
+	memcpy(&block[nblocks].firstEvent, time, sizeof(unsigned long long));
+      else
+	block[nblocks].firstEvent = ntriggers + 1;
+      ntriggers += nevents;
+
+      block[nblocks].typeIndex = ntypes;
+      len = simpleCtxGetTriggerBankTypeSegment(ctx, &evtype);
+      for(ievt = 0; ievt < nevents; ievt++)
+	type[ntypes++] = (ievt < len) ? evtype[ievt] : 0;
+
+      /* Slot events of this block, sorted, are written as they are found */
+      blockSlots = 0;
+      if(simpleIndexAddSlots(ctx, data, nwords, &slot, &slotSize, &blockSlots) != OK)
+	goto CLEANUP;
+      qsort(slot, blockSlots, sizeof(simpleIndexSlot), simpleIndexSlotCompare);
+      if(fwrite(slot, sizeof(simpleIndexSlot), blockSlots, out) != blockSlots)
+	goto WRITE_ERROR;
+
+      block[nblocks].slotIndex = nslots;
+      block[nblocks].nslots    = blockSlots;
+      nslots += blockSlots;
+      nblocks++;
+    }
+
+  key = (simpleIndexKey *) malloc((nblocks ? nblocks : 1) * sizeof(simpleIndexKey));
+  if(key == NULL)
+    {
+      printf("%s: ERROR: Unable to allocate %lu keys\n", __func__, (unsigned long)nblocks);
+      goto CLEANUP;
+    }
+  for(iblock = 0; iblock < nblocks; iblock++)
+    {
+      key[iblock].firstEvent = block[iblock].firstEvent;
+      key[iblock].block      = iblock;
+    }
+  qsort(key, nblocks, sizeof(simpleIndexKey), simpleIndexKeyCompare);
+
+  header.magic      = SIMPLE_INDEX_MAGIC;
+  header.version    = SIMPLE_INDEX_VERSION;
+  header.dataSize   = st.st_size;
+  header.nblocks    = nblocks;
+  header.nslots     = nslots;
+  header.ntypes     = ntypes;
+  header.slotOffset = sizeof(header);
+  header.typeOffset = header.slotOffset + nslots * sizeof(simpleIndexSlot);
+  /* Tables after the types start on an 8 byte boundary */
+  header.blockOffset = (header.typeOffset + ntypes * sizeof(unsigned short) + 7) & ~7ULL;
+  header.keyOffset   = header.blockOffset + nblocks * sizeof(simpleIndexBlock);
+
+  if(fwrite(type, sizeof(unsigned short), ntypes, out) != ntypes)
+    goto WRITE_ERROR;
+  if(fseek(out, header.blockOffset, SEEK_SET) != 0)
+    goto WRITE_ERROR;
+  if((fwrite(block, sizeof(simpleIndexBlock), nblocks, out) != nblocks) ||
+     (fwrite(key, sizeof(simpleIndexKey), nblocks, out) != nblocks))
+    goto WRITE_ERROR;
+  if((fseek(out, 0, SEEK_SET) != 0) ||
+     (fwrite(&header, sizeof(header), 1, out) != 1))
+    goto WRITE_ERROR;
+
+  rval = (int)nblocks;
+  goto CLEANUP;
+
+ WRITE_ERROR:
+  printf("%s: ERROR: Unable to write %s (%s)\n", __func__, name, strerror(errno));
+
+ CLEANUP:
+  if(out)
+    {
+      if(fclose(out) != 0)
+	rval = ERROR;
+      if(rval == ERROR)
+	unlink(name);
+    }
+  if(ctx)
+    simpleCtxDestroy(ctx);
+  simpleFileClose(file);
+  free(block);
+  free(slot);
+  free(type);
+  free(key);
+
+  return rval;
+}
+
+/**
+ * @ingroup Index
+ * @brief Open an EVIO file, and the index written by simpleIndexBuild
+ *
+ * @param filename   EVIO file
+ * @param indexname  Index file.  If NULL, filename with ".idx" appended.
+ *
+ * @return Address of the index if successful, otherwise NULL
+ */
+simpleIndex *
+simpleIndexOpen(const char *filename, const char *indexname)
+{
+  char name[4096];
+  simpleIndex *index;
+  const simpleIndexHeader *h;
+  struct stat st, dst;
+  int fd;
+
+  simpleIndexName(filename, indexname, name, sizeof(name));
+
+  if(stat(filename, &dst) != 0)
+    {
+      printf("%s: ERROR: Unable to stat %s (%s)\n", __func__, filename, strerror(errno));
+      return NULL;
+    }
+
+  fd = open(name, O_RDONLY);
+  if(fd < 0)
+    {
+      printf("%s: ERROR: Unable to open %s (%s)\n", __func__, name, strerror(errno));
+      return NULL;
+    }
+
+  if((fstat(fd, &st) != 0) || (st.st_size < (off_t)sizeof(simpleIndexHeader)))
+    {
+      printf("%s: ERROR: %s is not an index file\n", __func__, name);
+      close(fd);
+      return NULL;
+    }
+
+  index = (simpleIndex *) calloc(1, sizeof(simpleIndex));
+  if(index == NULL)
+    {
+      printf("%s: ERROR: Unable to allocate index\n", __func__);
+      close(fd);
+      return NULL;
+    }
+
+  index->mapSize = st.st_size;
+  index->map = mmap(NULL, index->mapSize, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if(index->map == MAP_FAILED)
+    {
+      printf("%s: ERROR: Unable to map %s (%s)\n", __func__, name, strerror(errno));
+      index->map = NULL;
+      simpleIndexClose(index);
+      return NULL;
+    }
+
+  h = index->header = (const simpleIndexHeader *)index->map;
+  if((h->magic != SIMPLE_INDEX_MAGIC) || (h->version != SIMPLE_INDEX_VERSION))
+    {
+      printf("%s: ERROR: %s is not a version %d index file\n",
+	     __func__, name, SIMPLE_INDEX_VERSION);
+      simpleIndexClose(index);
+      return NULL;
+    }
+
+  if(h->dataSize != (unsigned long long)dst.st_size)
+    {
+      printf("%s: ERROR: %s was built for a file of %llu bytes, %s has %llu\n",
+	     __func__, name, h->dataSize, filename, (unsigned long long)dst.st_size);
+      simpleIndexClose(index);
+      return NULL;
+    }
+
+  if((h->slotOffset + h->nslots * sizeof(simpleIndexSlot) > index->mapSize) ||
+     (h->typeOffset + h->ntypes * sizeof(unsigned short) > index->mapSize) ||
+     (h->keyOffset + h->nblocks * sizeof(simpleIndexKey) > index->mapSize) ||
+     (h->blockOffset + h->nblocks * sizeof(simpleIndexBlock) > index->mapSize))
+    {
+      printf("%s: ERROR: %s is truncated\n", __func__, name);
+      simpleIndexClose(index);
+      return NULL;
+    }
+
+  index->slot  = (const simpleIndexSlot *)((const char *)index->map + h->slotOffset);
+  index->type  = (const unsigned short *)((const char *)index->map + h->typeOffset);
+  index->block = (const simpleIndexBlock *)((const char *)index->map + h->blockOffset);
+  index->key   = (const simpleIndexKey *)((const char *)index->map + h->keyOffset);
+
+  madvise(index->map, index->mapSize, MADV_RANDOM);
+
+  index->file = simpleFileOpen(filename);
+  if(index->file == NULL)
+    {
+      simpleIndexClose(index);
+      return NULL;
+    }
+
+  return index;
+}
+
+/**
+ * @ingroup Index
+ * @brief Close an index, and its EVIO file.
+ *    Events from it may not be used afterwards.
+ *
+ * @param index Index from simpleIndexOpen
+ */
+void
+simpleIndexClose(simpleIndex *index)
+{
+  if(index == NULL)
+    return;
+
+  if(index->map)
+    munmap(index->map, index->mapSize);
+
+  simpleFileClose(index->file);
+
+  free(index->swapBuffer);
+  free(index);
+}
+
+/**
+ * @ingroup Index
+ * @brief Return the number of CODA events (blocks) in the index
+ *
+ * @param index Index from simpleIndexOpen
+ *
+ * @return Number of blocks if successful, otherwise ERROR
+ */
+int
+simpleIndexGetNblocks(simpleIndex *index)
+{
+  if(index == NULL)
+    return ERROR;
+
+  return (int)index->header->nblocks;
+}
+
+/**
+ * @ingroup Index
+ * @brief Find the CODA event (block) with a trigger event number.  O(log n)
+ *
+ * @param index   Index from simpleIndexOpen
+ * @param evnum   Trigger event number
+ * @param *block  Where to store the block
+ * @param *evt    Where to store the event in that block
+ *
+ * @return OK if found, otherwise ERROR
+ */
+int
+simpleIndexFindEvent(simpleIndex *index, unsigned long long evnum, int *block, int *evt)
+{
+  long lo = 0, hi, mid, found = -1;
+  const simpleIndexBlock *b;
+
+  if(index == NULL)
+    return ERROR;
+
+  /* Last block starting at or below evnum */
+  hi = (long)index->header->nblocks - 1;
+  while(lo <= hi)
+    {
+      mid = (lo + hi) / 2;
+      if(index->key[mid].firstEvent <= evnum)
+	{
+	  found = mid;
+	  lo = mid + 1;
+	}
+      else
+	hi = mid - 1;
+    }
+
+  if(found < 0)
+    return ERROR;
+
+  b = &index->block[index->key[found].block];
+  if(evnum >= b->firstEvent + b->nevents)
+    return ERROR;
+
+  *block = (int)index->key[found].block;
+  *evt   = (int)(evnum - b->firstEvent);
+
+  return OK;
+}
+
+#define CHECKBLOCK(x)						\
+  {								\
+    if((index == NULL) || ((x) < 0) ||				\
+       ((unsigned long long)(x) >= index->header->nblocks))	\
+      return -1;						\
+  }
+
+/**
+ * @ingroup Index
+ * @brief Return the trigger event number range of a CODA event (block)
+ *
+ * @param index        Index from simpleIndexOpen
+ * @param block        Block (0 is the first physics event of the file)
+ * @param *firstEvent  Where to store the event number of its first event
+ * @param *nevents     Where to store its number of events (block level)
+ *
+ * @return OK if successful, otherwise ERROR
+ */
+int
+simpleIndexGetBlockInfo(simpleIndex *index, int block, unsigned long long *firstEvent,
+			int *nevents)
+{
+  CHECKBLOCK(block);
+
+  *firstEvent = index->block[block].firstEvent;
+  *nevents    = index->block[block].nevents;
+
+  return OK;
+}
+
+/**
+ * @ingroup Index
+ * @brief Return the event type of an event of a CODA event (block)
+ *
+ * @param index  Index from simpleIndexOpen
+ * @param block  Block
+ * @param evt    Event in the block
+ *
+ * @return Event type if successful, otherwise ERROR
+ */
+int
+simpleIndexGetEventType(simpleIndex *index, int block, int evt)
+{
+  CHECKBLOCK(block);
+
+  if((evt < 0) || ((unsigned int)evt >= index->block[block].nevents))
+    return ERROR;
+
+  return index->type[index->block[block].typeIndex + evt];
+}
+
+/**
+ * @ingroup Index
+ * @brief Read a CODA event (block) from the file, without scanning it.
+ *    Moves the file reader to the event after it.
+ *
+ * @param index    Index from simpleIndexOpen
+ * @param block    Block
+ * @param **data   Where to store the address of the event (in the file mapping)
+ * @param *nwords  Where to store its length, in words
+ *
+ * @return OK if successful, otherwise ERROR
+ */
+int
+simpleIndexGetBlock(simpleIndex *index, int block, unsigned int **data, int *nwords)
+{
+  const simpleIndexBlock *b;
+
+  CHECKBLOCK(block);
+
+  b = &index->block[block];
+  if(simpleFileSeek(index->file, b->fileBlock, b->fileEvent) != OK)
+    return ERROR;
+
+  if(simpleFileRead(index->file, data, nwords) != OK)
+    return ERROR;
+
+  if(*nwords != (int)b->nwords)
+    {
+      printf("%s: ERROR: Block %d has %d words, index has %u.  Index is stale?\n",
+	     __func__, block, *nwords, b->nwords);
+      return ERROR;
+    }
+
+  return OK;
+}
+
+/**
+ * @ingroup Index
+ * @brief Return the data of a slot's event, from the offsets in the index.
+ *    Same as simpleGetSlotEventData, without scanning the CODA event.
+ *    A bank configured with simpleConfigBankSwap is swapped to native
+ *    order into a buffer of the index, used until the next call.  Other
+ *    banks are returned in the file mapping, as they are in the file.
+ *
+ * @param index     Index from simpleIndexOpen
+ * @param block     Block
+ * @param rocID     ROC
+ * @param bank      Bank
+ * @param slot      Slot
+ * @param evt       Event in the block
+ * @param **buffer  Where to store the address of the data
+ *
+ * @return Length of the data if successful, otherwise -1
+ */
+int
+simpleIndexGetSlotEventData(simpleIndex *index, int block, int rocID, int bank, int slot,
+			    int evt, unsigned int **buffer)
+{
+  const simpleIndexBlock *b;
+  const simpleIndexSlot *s = NULL;
+  simpleIndexSlot want;
+  unsigned int *data;
+  long lo, hi, mid;
+  int nwords, cmp;
+
+  CHECKBLOCK(block);
+
+  if((rocID < 0) || (rocID >= SIMPLE_MAX_ROCS) || (bank < 0) || (bank > 0xFFFF) ||
+     (slot < 0) || (slot >= SIMPLE_MAX_SLOTS) || (evt < 0) || (evt > SIMPLE_MAX_BLOCKLEVEL))
+    return -1;
+
+  want.rocID  = rocID;
+  want.bankID = bank;
+  want.slot   = slot;
+  want.evt    = evt;
+
+  b = &index->block[block];
+  lo = 0;
+  hi = (long)b->nslots - 1;
+  while(lo <= hi)
+    {
+      mid = (lo + hi) / 2;
+      cmp = simpleIndexSlotCompare(&want, &index->slot[b->slotIndex + mid]);
+      if(cmp == 0)
+	{
+	  s = &index->slot[b->slotIndex + mid];
+	  break;
+	}
+      if(cmp < 0)
+	hi = mid - 1;
+      else
+	lo = mid + 1;
+    }
+
+  if(s == NULL)
+    return -1;
+
+  if(simpleIndexGetBlock(index, block, &data, &nwords) != OK)
+    return -1;
+
+  *buffer = &data[s->offset];
+
+  if(s->swap && (s->length > 0))
+    {
+      if(simpleIndexGrow((void **)&index->swapBuffer, &index->swapSize, s->length,
+			 sizeof(unsigned int)) != OK)
+	return -1;
+
+      simpleKernelGet()->swap32(index->swapBuffer, *buffer, s->length);
+      *buffer = index->swapBuffer;
+    }
+
+  return s->length;
+}
@@ -0,0 +1,499 @@
+/*----------------------------------------------------------------------------*/
+/**
+ * @mainpage
+ * <pre>
+ *  Copyright (c) 2014        Southeastern Universities Research Association, *
+ *                            Thomas Jefferson National Accelerator Facility  *
+ *                                                                            *
+ *    This software was developed under a United States Government license    *
+ *    described in the NOTICE file included as part of this distribution.     *
+ *                                                                            *
+ *    Authors: Bryan Moffit                                                   *
+ *             moffit@jlab.org                   Jefferson Lab, MS-12B3       *
+ *             Phone: (757) 269-5660             12000 Jefferson Ave.         *
+ *             Fax:   (757) 269-5800             Newport News, VA 23606       *
+ *                                                                            *
+ *----------------------------------------------------------------------------*
+ *
+ * Description:
+ *     Word kernels for the simple library, with scalar, SSE2 and AVX2
+ *     versions.  The best one supported by the CPU is selected at run
+ *     time, unless one is requested with simpleConfigKernel().
+ *
+ * </pre>
+ *----------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <byteswap.h>
+#include "simpleLib.h"
+#include "simpleKernel.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SIMPLE_KERNEL_X86
+#include <immintrin.h>
+#endif
+
+/* Scalar */
+static unsigned long long
+simpleDefiningMaskScalar(const unsigned int *data, int n)
+{
+  unsigned long long mask = 0;
+  int iword;
+
+  for(iword = 0; iword < n; iword++)
+    mask |= (unsigned long long)(data[iword] >> 31) << iword;
+
+  return mask;
+}
+
+static unsigned long long
+simpleDefiningMaskSwapScalar(const unsigned int *data, int n)
+{
+  unsigned long long mask = 0;
+  int iword;
+
+  /* Bit 31 of the swapped word is bit 7 of the raw word */
+  for(iword = 0; iword < n; iword++)
+    mask |= (unsigned long long)((data[iword] >> 7) & 1) << iword;
+
+  return mask;
+}
+
+static void
+simpleSwap32Scalar(unsigned int *dst, const unsigned int *src, int n)
+{
+  int iword;
+
+  for(iword = 0; iword < n; iword++)
+    dst[iword] = bswap_32(src[iword]);
+}
+
+static unsigned long long
+simpleSequenceMaskScalar(const unsigned int *data, int n, unsigned int first, unsigned int mask)
+{
+  unsigned long long bad = 0;
+  int iword;
+
+  for(iword = 0; iword < n; iword++)
+    bad |= (unsigned long long)(((data[iword] ^ (first + iword)) & mask) != 0) << iword;
+
+  return bad;
+}
+
+static void
+simpleSwap64Scalar(unsigned long long *dst, const unsigned int *src, int n)
+{
+  unsigned long long value;
+  int i;
+
+  for(i = 0; i < n; i++)
+    {
+      memcpy(&value, &src[2 * i], sizeof(value));
+      dst[i] = bswap_64(value);
+    }
+}
+
+static void
+simpleSwap16Scalar(unsigned short *dst, const unsigned short *src, int n)
+{
+  int i;
+
+  for(i = 0; i < n; i++)
+    dst[i] = bswap_16(src[i]);
+}
+
+#ifdef SIMPLE_KERNEL_X86
+/* SSE2, 16 words at a time.  The signed saturating packs keep the sign
+   bit of each word, so one movemask covers 16 words */
+static inline unsigned int
+simpleSignMask16SSE2(__m128i a, __m128i b, __m128i c, __m128i d)
+{
+  return _mm_movemask_epi8(_mm_packs_epi16(_mm_packs_epi32(a, b),
+					   _mm_packs_epi32(c, d)));
+}
+
+static unsigned long long
+simpleDefiningMaskSSE2(const unsigned int *data, int n)
+{
+  const __m128i *v = (const __m128i *) data;
+  unsigned long long mask = 0;
+  int iword;
+
+  for(iword = 0; iword + 16 <= n; iword += 16, v += 4)
+    mask |= (unsigned long long)
+      simpleSignMask16SSE2(_mm_loadu_si128(v), _mm_loadu_si128(v + 1),
+			   _mm_loadu_si128(v + 2), _mm_loadu_si128(v + 3)) << iword;
+
+  if(iword < n)
+    mask |= simpleDefiningMaskScalar(&data[iword], n - iword) << iword;
+
+  return mask;
+}
+
+static unsigned long long
+simpleDefiningMaskSwapSSE2(const unsigned int *data, int n)
+{
+  const __m128i *v = (const __m128i *) data;
+  unsigned long long mask = 0;
+  int iword;
+
+  /* Bit 31 of the swapped word is bit 7 of the raw word */
+  for(iword = 0; iword + 16 <= n; iword += 16, v += 4)
+    mask |= (unsigned long long)
+      simpleSignMask16SSE2(_mm_slli_epi32(_mm_loadu_si128(v), 24),
+			   _mm_slli_epi32(_mm_loadu_si128(v + 1), 24),
+			   _mm_slli_epi32(_mm_loadu_si128(v + 2), 24),
+			   _mm_slli_epi32(_mm_loadu_si128(v + 3), 24)) << iword;
+
+  if(iword < n)
+    mask |= simpleDefiningMaskSwapScalar(&data[iword], n - iword) << iword;
+
+  return mask;
+}
+
+/* SSE2 has no byte shuffle.  Swap the bytes of each 16 bit half,
+   then swap the halves */
+static void
+simpleSwap32SSE2(unsigned int *dst, const unsigned int *src, int n)
+{
+  int iword;
+
+  for(iword = 0; iword + 4 <= n; iword += 4)
+    {
+      __m128i v = _mm_loadu_si128((const __m128i *)&src[iword]);
+
+      v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+      v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+      v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+      _mm_storeu_si128((__m128i *)&dst[iword], v);
+    }
+
+  if(iword < n)
+    simpleSwap32Scalar(&dst[iword], &src[iword], n - iword);
+}
+
+/* Compare 4 words at a time with the next 4 of the sequence */
+static unsigned long long
+simpleSequenceMaskSSE2(const unsigned int *data, int n, unsigned int first, unsigned int mask)
+{
+  const __m128i vmask = _mm_set1_epi32(mask), four = _mm_set1_epi32(4);
+  __m128i expect = _mm_add_epi32(_mm_set1_epi32(first), _mm_setr_epi32(0, 1, 2, 3));
+  unsigned long long bad = 0;
+  int iword;
+
+  for(iword = 0; iword + 4 <= n; iword += 4)
+    {
+      __m128i v = _mm_xor_si128(_mm_loadu_si128((const __m128i *)&data[iword]), expect);
+      __m128i eq = _mm_cmpeq_epi32(_mm_and_si128(v, vmask), _mm_setzero_si128());
+
+      bad |= (unsigned long long)(~_mm_movemask_ps(_mm_castsi128_ps(eq)) & 0xF) << iword;
+      expect = _mm_add_epi32(expect, four);
+    }
+
+  if(iword < n)
+    bad |= simpleSequenceMaskScalar(&data[iword], n - iword, first + iword, mask) << iword;
+
+  return bad;
+}
+
+/* As simpleSwap32SSE2, then swap the 32 bit halves */
+static void
+simpleSwap64SSE2(unsigned long long *dst, const unsigned int *src, int n)
+{
+  int i;
+
+  for(i = 0; i + 2 <= n; i += 2)
+    {
+      __m128i v = _mm_loadu_si128((const __m128i *)&src[2 * i]);
+
+      v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+      v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+      v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+      _mm_storeu_si128((__m128i *)&dst[i], v);
+    }
+
+  if(i < n)
+    simpleSwap64Scalar(&dst[i], &src[2 * i], n - i);
+}
+
+static void
+simpleSwap16SSE2(unsigned short *dst, const unsigned short *src, int n)
+{
+  int i;
+
+  for(i = 0; i + 8 <= n; i += 8)
+    {
+      __m128i v = _mm_loadu_si128((const __m128i *)&src[i]);
+
+      _mm_storeu_si128((__m128i *)&dst[i],
+		       _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8)));
+    }
+
+  if(i < n)
+    simpleSwap16Scalar(&dst[i], &src[i], n - i);
+}
+
+/* AVX2, 32 words at a time.  The packs work within each 128 bit lane,
+   so the result is put back in word order before the movemask. */
+__attribute__((target("avx2")))
+static inline unsigned int
+simpleSignMask32AVX2(__m256i a, __m256i b, __m256i c, __m256i d)
+{
+  __m256i x = _mm256_packs_epi16(_mm256_packs_epi32(a, b), _mm256_packs_epi32(c, d));
+
+  x = _mm256_permutevar8x32_epi32(x, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+
+  return (unsigned int)_mm256_movemask_epi8(x);
+}
+
+__attribute__((target("avx2")))
+static unsigned long long
+simpleDefiningMaskAVX2(const unsigned int *data, int n)
+{
+  const __m256i *v = (const __m256i *) data;
+  unsigned long long mask = 0;
+  int iword;
+
+  for(iword = 0; iword + 32 <= n; iword += 32, v += 4)
+    mask |= (unsigned long long)
+      simpleSignMask32AVX2(_mm256_loadu_si256(v), _mm256_loadu_si256(v + 1),
+			   _mm256_loadu_si256(v + 2), _mm256_loadu_si256(v + 3)) << iword;
+
+  if(iword < n)
+    mask |= simpleDefiningMaskSSE2(&data[iword], n - iword) << iword;
+
+  return mask;
+}
+
+__attribute__((target("avx2")))
+static unsigned long long
+simpleDefiningMaskSwapAVX2(const unsigned int *data, int n)
+{
+  const __m256i *v = (const __m256i *) data;
+  unsigned long long mask = 0;
+  int iword;
+
+  for(iword = 0; iword + 32 <= n; iword += 32, v += 4)
+    mask |= (unsigned long long)
+      simpleSignMask32AVX2(_mm256_slli_epi32(_mm256_loadu_si256(v), 24),
+			   _mm256_slli_epi32(_mm256_loadu_si256(v + 1), 24),
+			   _mm256_slli_epi32(_mm256_loadu_si256(v + 2), 24),
+			   _mm256_slli_epi32(_mm256_loadu_si256(v + 3), 24)) << iword;
+
+  if(iword < n)
+    mask |= simpleDefiningMaskSwapSSE2(&data[iword], n - iword) << iword;
+
+  return mask;
+}
+__attribute__((target("avx2")))
+static void
+simpleSwap32AVX2(unsigned int *dst, const unsigned int *src, int n)
+{
+  const __m256i shuffle = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4,
+					   11, 10, 9, 8, 15, 14, 13, 12,
+					   3, 2, 1, 0, 7, 6, 5, 4,
+					   11, 10, 9, 8, 15, 14, 13, 12);
+  int iword;
+
+  for(iword = 0; iword + 16 <= n; iword += 16)
+    {
+      __m256i a = _mm256_loadu_si256((const __m256i *)&src[iword]);
+      __m256i b = _mm256_loadu_si256((const __m256i *)&src[iword + 8]);
+
+      _mm256_storeu_si256((__m256i *)&dst[iword], _mm256_shuffle_epi8(a, shuffle));
+      _mm256_storeu_si256((__m256i *)&dst[iword + 8], _mm256_shuffle_epi8(b, shuffle));
+    }
+
+  if(iword < n)
+    simpleSwap32SSE2(&dst[iword], &src[iword], n - iword);
+}
+
+__attribute__((target("avx2")))
+static unsigned long long
+simpleSequenceMaskAVX2(const unsigned int *data, int n, unsigned int first, unsigned int mask)
+{
+  const __m256i vmask = _mm256_set1_epi32(mask), eight = _mm256_set1_epi32(8);
+  __m256i expect = _mm256_add_epi32(_mm256_set1_epi32(first),
+				    _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+  unsigned long long bad = 0;
+  int iword;
+
+  for(iword = 0; iword + 8 <= n; iword += 8)
+    {
+      __m256i v = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)&data[iword]), expect);
+      __m256i eq = _mm256_cmpeq_epi32(_mm256_and_si256(v, vmask), _mm256_setzero_si256());
+
+      bad |= (unsigned long long)(~_mm256_movemask_ps(_mm256_castsi256_ps(eq)) & 0xFF) << iword;
+      expect = _mm256_add_epi32(expect, eight);
+    }
+
+  if(iword < n)
+    bad |= simpleSequenceMaskSSE2(&data[iword], n - iword, first + iword, mask) << iword;
+
+  return bad;
+}
+
+__attribute__((target("avx2")))
+static void
+simpleSwap64AVX2(unsigned long long *dst, const unsigned int *src, int n)
+{
+  const __m256i shuffle = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0,
+					   15, 14, 13, 12, 11, 10, 9, 8,
+					   7, 6, 5, 4, 3, 2, 1, 0,
+					   15, 14, 13, 12, 11, 10, 9, 8);
+  int i;
+
+  for(i = 0; i + 4 <= n; i += 4)
+    {
+      __m256i v = _mm256_loadu_si256((const __m256i *)&src[2 * i]);
+
+      _mm256_storeu_si256((__m256i *)&dst[i], _mm256_shuffle_epi8(v, shuffle));
+    }
+
+  if(i < n)
+    simpleSwap64SSE2(&dst[i], &src[2 * i], n - i);
+}
+
+__attribute__((target("avx2")))
+static void
+simpleSwap16AVX2(unsigned short *dst, const unsigned short *src, int n)
+{
+  int i;
+
+  for(i = 0; i + 16 <= n; i += 16)
+    {
+      __m256i v = _mm256_loadu_si256((const __m256i *)&src[i]);
+
+      _mm256_storeu_si256((__m256i *)&dst[i],
+			  _mm256_or_si256(_mm256_slli_epi16(v, 8), _mm256_srli_epi16(v, 8)));
+    }
+
+  if(i < n)
+    simpleSwap16SSE2(&dst[i], &src[i], n - i);
+}
+#endif /* SIMPLE_KERNEL_X86 */
+
+static const simpleKernel simpleKernels[] =
+  {
+    {
+      SIMPLE_KERNEL_SCALAR, "scalar",
+      simpleDefiningMaskScalar, simpleDefiningMaskSwapScalar,
+      simpleSequenceMaskScalar,
+      simpleSwap32Scalar, simpleSwap64Scalar, simpleSwap16Scalar
+    },
+#ifdef SIMPLE_KERNEL_X86
+    {
+      SIMPLE_KERNEL_SSE2, "sse2",
+      simpleDefiningMaskSSE2, simpleDefiningMaskSwapSSE2,
+      simpleSequenceMaskSSE2,
+      simpleSwap32SSE2, simpleSwap64SSE2, simpleSwap16SSE2
+    },
+    {
+      SIMPLE_KERNEL_AVX2, "avx2",
+      simpleDefiningMaskAVX2, simpleDefiningMaskSwapAVX2,
+      simpleSequenceMaskAVX2,
+      simpleSwap32AVX2, simpleSwap64AVX2, simpleSwap16AVX2
+    },
+#endif
+  };
+
+#define SIMPLE_NKERNELS  (int)(sizeof(simpleKernels) / sizeof(simpleKernel))
+
+static const simpleKernel *simpleCurrentKernel = NULL;
+static pthread_once_t simpleKernelOnce = PTHREAD_ONCE_INIT;
+
+static int
+simpleKernelSupported(int type)
+{
+  switch(type)
+    {
+    case SIMPLE_KERNEL_SCALAR:
+      return 1;
+#ifdef SIMPLE_KERNEL_X86
+    case SIMPLE_KERNEL_SSE2:
+      return __builtin_cpu_supports("sse2");
+    case SIMPLE_KERNEL_AVX2:
+      return __builtin_cpu_supports("avx2");
+#endif
+    default:
+      return 0;
+    }
+}
+
+/* Best kernel supported by this CPU */
+static void
+simpleKernelInit()
+{
+  int ikernel;
+
+  __builtin_cpu_init();
+
+  for(ikernel = SIMPLE_NKERNELS - 1; ikernel >= 0; ikernel--)
+    {
+      if(simpleKernelSupported(simpleKernels[ikernel].type))
+	{
+	  simpleCurrentKernel = &simpleKernels[ikernel];
+	  break;
+	}
+    }
+}
+
+const simpleKernel *
+simpleKernelGet()
+{
+  pthread_once(&simpleKernelOnce, simpleKernelInit);
+
+  return simpleCurrentKernel;
+}
+
+/**
+ * @ingroup Config
+ * @brief Select the word kernels used to scan the data banks.
+ *        Call before scanning.
+ *
+ * @param type  SIMPLE_KERNEL_AUTO (default) for the best one supported by this CPU,
+ *              or one of SIMPLE_KERNEL_SCALAR, SIMPLE_KERNEL_SSE2, SIMPLE_KERNEL_AVX2
+ *
+ * @return OK if successful, otherwise ERROR
+ */
+int
+simpleConfigKernel(int type)
+{
+  int ikernel;
+
+  pthread_once(&simpleKernelOnce, simpleKernelInit);
+
+  if(type == SIMPLE_KERNEL_AUTO)
+    {
+      simpleKernelInit();
+      return OK;
+    }
+
+  for(ikernel = 0; ikernel < SIMPLE_NKERNELS; ikernel++)
+    {
+      if(simpleKernels[ikernel].type == type)
+	{
+	  if(!simpleKernelSupported(type))
+	    break;
+
+	  simpleCurrentKernel = &simpleKernels[ikernel];
+	  return OK;
+	}
+    }
+
+  printf("%s: ERROR: Kernel type %d not supported\n", __func__, type);
+
+  return ERROR;
+}
+
+/**
+ * @ingroup Config
+ * @brief Return the name of the word kernels in use
+ */
+const char *
+simpleGetKernelName()
+{
+  return simpleKernelGet()->name;
+}
@@ -0,0 +1,51 @@
+#ifndef __SIMPLEKERNELH__
+#define __SIMPLEKERNELH__
+/*----------------------------------------------------------------------------*/
+/**
+ * <pre>
+ *  Copyright (c) 2014        Southeastern Universities Research Association, *
+ *                            Thomas Jefferson National Accelerator Facility  *
+ *                                                                            *
+ *    This software was developed under a United States Government license    *
+ *    described in the NOTICE file included as part of this distribution.     *
+ *                                                                            *
+ *----------------------------------------------------------------------------*
+ *
+ * Description:
+ *     Internal header for the simple library's word kernels.
+ *     Not installed.
+ *
+ * </pre>
+ *----------------------------------------------------------------------------*/
+
+/* Maximum number of words classified by one call */
+#define SIMPLE_KERNEL_WORDS  64
+
+typedef struct KernelStruct
+{
+  int         type;
+  const char *name;
+
+  /* Bitmask of the words in data[0..n-1] with the data type defining bit set.
+     n <= SIMPLE_KERNEL_WORDS.  The Swap version checks the byte-swapped word */
+  unsigned long long (*definingMask)(const unsigned int *data, int n);
+  unsigned long long (*definingMaskSwap)(const unsigned int *data, int n);
+
+  /* Bitmask of the words in data[0..n-1] with (data[i] & mask) != ((first + i) & mask).
+     n <= SIMPLE_KERNEL_WORDS */
+  unsigned long long (*sequenceMask)(const unsigned int *data, int n,
+				     unsigned int first, unsigned int mask);
+
+  /* Byte swap n words of src into dst.  dst may be the same as src */
+  void (*swap32)(unsigned int *dst, const unsigned int *src, int n);
+
+  /* Byte swap n 64 bit values of src (32 bit aligned) into dst */
+  void (*swap64)(unsigned long long *dst, const unsigned int *src, int n);
+
+  /* Byte swap n 16 bit values of src into dst.  dst may be the same as src */
+  void (*swap16)(unsigned short *dst, const unsigned short *src, int n);
+} simpleKernel;
+
+const simpleKernel *simpleKernelGet();
+
+#endif /* __SIMPLEKERNELH__ */
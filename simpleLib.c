@@ -25,33 +25,183 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
+#include <limits.h>
 #include <byteswap.h>
 #include "simpleLib.h"
+#include "simpleTaskPool.h"
+#include "simpleKernel.h"
 
 typedef void (*VOIDFUNCPTR) ();
 
-/* Global Variables */
-simpleDebug        simpleDebugMask=0;
-
-/* data address provided by user */
-unsigned long dataAddr = 0;
-
-/* Trigger Bank of Segment */
-trigBankInfo trigBank;
-
-/* ROC Banks */
-rocBankInfo rocBank[SIMPLE_MAX_ROCS];
-int nRocs;
-
 /* Payload module data (fADC250, fADC125, f1TDC) */
-/* Bank Data - Banks of 4 byte unsigned integers */
-bankDataInfo bankData[SIMPLE_MAX_ROCS][SIMPLE_MAX_BANKS];
+/* Bank Data - Banks of 4 byte unsigned integers.
+   Only allocated for the ROC/bank pairs (and slots) found in the event */
+typedef struct PoolStruct
+{
+  size_t elsize;
+  int    nused;
+  int    nchunks;
+  char **chunk;
+
+  /* Event data of the slots from a slot pool, taken in order from chunks */
+  simpleEventData **evtChunk;
+  int    nevtChunks;
+  int    evtChunkUsed;		/* Chunk being taken from */
+  int    evtUsed;		/* Entries taken from it */
+} simplePool;
+
+#define SIMPLE_POOL_CHUNK   64
+/* Entries of a chunk of event data.  Room for the largest block (or event view) */
+#define SIMPLE_EVT_CHUNK    (SIMPLE_MAX_SLOTS * (SIMPLE_MAX_BLOCKLEVEL + 1))
+
+/* Lookup of bankData by (rocID, bank tag).  Entries are only valid
+   if their generation matches the current one. */
+typedef struct BankHashStruct
+{
+  unsigned int  key;
+  unsigned int  gen;
+  bankDataInfo *bank;
+} bankHashEntry;
+
+#define SIMPLE_BANK_HASH_BITS  10
+
+/* Where simpleCtxStreamFeed() is in the event */
+#define SIMPLE_STREAM_STATE_IDLE     0	/* No event started */
+#define SIMPLE_STREAM_STATE_HEADER   1	/* Waiting for the event length */
+#define SIMPLE_STREAM_STATE_TRIGGER  2	/* Waiting for the trigger bank */
+#define SIMPLE_STREAM_STATE_ROCS     3	/* Waiting for the next ROC bank */
+#define SIMPLE_STREAM_STATE_DONE     4
+#define SIMPLE_STREAM_STATE_ERROR    5
+
+/* Last block number of each slot of a bank, for simpleCtxCheckSync() */
+typedef struct SyncBankStruct
+{
+  int            rocID;
+  int            bankID;
+  unsigned int   slotMask;	/* Slots with a block number */
+  unsigned short blockNumber[SIMPLE_MAX_SLOTS];
+} simpleSyncBank;
+
+/* Trace records, written by any thread scanning for the context */
+struct SimpleTraceStruct
+{
+  simpleTraceRecord  *record;
+  unsigned int        mask;	/* Number of records - 1 */
+  unsigned long long  head;	/* Records written, the next one at head & mask */
+};
+
+/* Scan context.  Everything indexed from one CODA event. */
+struct SimpleCtxStruct
+{
+  const simpleConfig *config;	/* Bank configuration, shared read-only */
+  simpleDebug    debugMask;
+  simpleTrace   *trace;		/* NULL if not tracing */
+  int            lazy;		/* Index data banks when they are first accessed */
+  int            validate;	/* simpleValidate level */
+  int            stats;		/* Count and time the scans */
+
+  /* data address provided by user */
+  unsigned long  dataAddr;
+
+  /* Ring the event was scanned in by simpleCtxScanRing().  Event words from
+     ringWrap on are at ringBase.  ringWrap is INT_MAX otherwise */
+  unsigned int  *ringBase;
+  int            ringWrap;
+
+  /* Event fed to simpleCtxStreamFeed() */
+  int            streamState;	/* SIMPLE_STREAM_STATE_* */
+  int            streamBufferWords;
+  int            streamNext;	/* Index of the next ROC bank */
+
+  /* Trigger Bank of Segment */
+  trigBankInfo   trigBank;
+  /* rocIDs of the trigger bank ROC segments found in the last event */
+  int            trigRocList[SIMPLE_MAX_ROCS];
+
+  /* ROC Banks */
+  rocBankInfo    rocBank[SIMPLE_MAX_ROCS];
+  int            nRocs;
+  int            rocList[SIMPLE_MAX_ROCS];	/* rocIDs found in the last event */
+
+  simplePool     bankPool;
+  simplePool     slotPool;
+
+  /* Parallel bank scanning */
+  simpleTaskPool *taskPool;
+  simplePool     *taskSlotPool;	/* Slot data allocated by each worker */
+  bankDataInfo  **taskBank;	/* Banks to scan, most words first */
+  int             taskBankSize;
+  volatile unsigned int *taskData;
+
+  /* Destination of banks configured with SIMPLE_SWAP_BUFFER */
+  unsigned int  *swapBuffer;
+  int            swapBufferSize;
+  int            swapBufferUsed;
+
+  bankHashEntry *bankHash;
+  unsigned int   bankHashBits;
+  unsigned int   bankHashGen;
+  int            bankHashCount;
+
+  /* Disentangled events, built by the first simpleCtxGetEvent() after a scan */
+  int              eventsBuilt;
+  int              nEvents;
+  int              eventStart[SIMPLE_MAX_BLOCKLEVEL+2];	/* First eventSlot of each event */
+  simpleEventSlot *eventSlot;	/* Slots of event 0, then event 1, ... */
+  int              eventSlotSize;
+
+  /* Banks stepped over by ignoreUndefinedBanks, counted over every scan */
+  simpleSkipCount *skipCount;
+  int              nSkipCount;
+  int              skipCountSize;
+  int              skipCountNext;	/* Entry after the last one counted */
+
+  /* Scan statistics, counted while stats is set (SIMPLE_STATS builds) */
+  simpleStats      stat;
+  simpleBankStats *bankStats;
+  int              nBankStats;
+  int              bankStatsSize;
+  int              bankStatsNext;	/* Entry after the last one counted */
+
+  /* Errors found by the scans: the last SIMPLE_MAX_ERRORS, and a count of each */
+  unsigned long long nscans;	/* Events scanned, numbers simpleError.event */
+  simpleError        error[SIMPLE_MAX_ERRORS];
+  unsigned long long errorHead;	/* Errors recorded, the next at errorHead % SIMPLE_MAX_ERRORS */
+  unsigned long long errorCount[SIMPLE_ERROR_NCODES];
+  int                errorPrintRate;	/* Errors printed per second, -1 all, 0 none */
+  long               errorPrintSecond;	/* Second of the errors counted in errorPrinted */
+  int                errorPrinted;
+  int                errorSuppressed;	/* Not printed, since the last one that was */
+
+  /* Event and block number checks of simpleCtxCheckSync(), over every block checked */
+  simpleSyncStats    sync;
+  simpleSyncBank    *syncBank;
+  int                nSyncBank;
+  int                syncBankSize;
+  int                syncBankNext;	/* Entry after the last one checked */
+};
 
-int               ignoreUndefinedBanks=0;        /* Default is false */
+/* Global Variables */
+simpleDebug        simpleDebugMask=0;	/* Debug mask for new contexts */
+int                simpleValidateLevel=SIMPLE_VALIDATE_FULL;	/* Validation level for new contexts */
+int                simpleStatsEnable=0;	/* Stats of new contexts */
+int                simpleTraceRecords=0;	/* Trace records of new contexts */
+int                simpleErrorPrintRate=SIMPLE_ERROR_PRINT_RATE;	/* Of new contexts */
 
 /* User defined Banks for separate modules, configured before run */
-simpleBankConfig uBank[SIMPLE_MAX_BANKS];
-int nubanks = 0;
+simpleConfig       simpleGlobalConfig;
+
+/* Context used by the routines that do not take one */
+static simpleCtx   simpleDefaultCtx =
+  {
+    .config   = &simpleGlobalConfig,
+    .validate = SIMPLE_VALIDATE_FULL,
+    .ringWrap = INT_MAX,
+    .errorPrintRate = SIMPLE_ERROR_PRINT_RATE,
+    .bankPool = { sizeof(bankDataInfo), 0, 0, NULL },
+    .slotPool = { sizeof(slotDataInfo), 0, 0, NULL }
+  };
 
 /* Other data, to be copied to only one event... or to every event in the block */
 otherBankInfo     otherBank[SIMPLE_MAX_BANKS];
@@ -65,9 +215,10 @@ const simpleBankConfig BANK_CONFIG_DEFAULTS =
     0,  /* rocID */
     SIMPLE_LITTLE_ENDIAN, /* endian */
     0,    /* isBlocked */
+    SIMPLE_SWAP_NONE, /* swapMode */
     0,    /* module_header */
     0xFFFFFFFF, /* header_mask */
-    (VOIDFUNCPTR)simpleScanBank /* firstPassRoutine */
+    (VOIDFUNCPTR)simpleScanJLab /* firstPassRoutine */
   };
 
 int
@@ -76,10 +227,11 @@ simpleInit()
   int ibank;
   for(ibank = 0; ibank < SIMPLE_MAX_BANKS; ibank++)
     {
-      uBank[ibank] = BANK_CONFIG_DEFAULTS;
+      simpleGlobalConfig.uBank[ibank] = BANK_CONFIG_DEFAULTS;
     }
 
-  nubanks = 0;
+  simpleGlobalConfig.nubanks = 0;
+  memset(simpleGlobalConfig.lookup, 0, sizeof(simpleGlobalConfig.lookup));
 
   return OK;
 }
@@ -95,18 +247,70 @@ void
 simpleConfigSetDebug(int dbMask)
 {
   simpleDebugMask = dbMask;
+  simpleDefaultCtx.debugMask = dbMask;
+}
+
+/**
+ * @ingroup Config
+ * @brief Set the debug mask of a single scan context
+ *
+ * @param ctx    Scan context
+ * @param dbMask Mask of debugging bits
+ *
+ */
+void
+simpleCtxSetDebug(simpleCtx *ctx, int dbMask)
+{
+  ctx->debugMask = dbMask;
+}
+
+static unsigned int
+simpleBankKey(int rocID, int bankID)
+{
+  return ((unsigned int)rocID << 16) | ((unsigned int)bankID & 0xFFFF);
+}
+
+/* Entry of the configuration lookup holding (rocID, tag), or the empty
+   entry where it would go */
+static int
+simpleConfigLookupSlot(const simpleConfig *config, int rocID, int tag)
+{
+  unsigned int ihash, mask = SIMPLE_CONFIG_LOOKUP_SIZE - 1;
+  const simpleBankConfig *ub;
+
+  ihash = (simpleBankKey(rocID, tag) * 0x9E3779B1u) >> (32 - SIMPLE_CONFIG_LOOKUP_BITS);
+
+  while(config->lookup[ihash])
+    {
+      ub = &config->uBank[config->lookup[ihash] - 1];
+      if((ub->rocID == rocID) && (ub->header.bf.tag == tag))
+	break;
+      ihash = (ihash + 1) & mask;
+    }
+
+  return ihash;
+}
+
+/* Index of the configuration of (rocID, tag) in uBank, otherwise -1 */
+static int
+simpleFindConfigBankIndex(const simpleConfig *config, int rocID, int tag)
+{
+  return config->lookup[simpleConfigLookupSlot(config, rocID, tag)] - 1;
 }
 
 /**
  * @ingroup Config
  * @brief Configure Banks to be indexed
  *
+ *    Configuring a rocID and bankID again replaces its settings.
+ *
  * @param rocID             roc ID
  * @param bankID            Bank ID
  * @param num               NOT USED
  * @param endian            little = 0, big = 1
  * @param isBlocked         no = 0, yes = 1
  * @param firstPassRoutine  Routine to call for first pass processing
+ *                          (a simpleScanRoutine, NULL for simpleScanJLab)
  *
  * @return OK if successful, otherwise ERROR
  */
@@ -115,828 +319,4267 @@ int
 simpleConfigBank(int rocID, int bankID, int num,
 		 int endian, int isBlocked, void *firstPassRoutine)
 {
+  simpleBankConfig *ub;
+  int ihash;
 
-  if(firstPassRoutine==NULL)
+  if((rocID < 0) || (rocID >= SIMPLE_MAX_ROCS) || (bankID < 0) || (bankID > 0xFFFF))
     {
-      firstPassRoutine=simpleScanBank;
+      printf("%s: ERROR: Invalid rocID = %d, bankID = 0x%x\n",
+	     __func__, rocID, bankID);
+      return ERROR;
     }
 
-  uBank[nubanks].rocID             = rocID;
-  uBank[nubanks].header.bf.tag     = bankID;
-  uBank[nubanks].header.bf.num     = num;
-  uBank[nubanks].endian            = endian;
-  uBank[nubanks].isBlocked         = isBlocked;
-  uBank[nubanks].firstPassRoutine  = firstPassRoutine;
-
-  nubanks++;
-
-  return OK;
-}
-
-int
-simpleFindConfigBankIndex(int rocID, int tag)
-{
-  int ibank = 0;
+  if(firstPassRoutine==NULL)
+    {
+      firstPassRoutine=simpleScanJLab;
+    }
 
-  for(ibank = 0; ibank < nubanks; ibank++)
+  ihash = simpleConfigLookupSlot(&simpleGlobalConfig, rocID, bankID);
+  if(simpleGlobalConfig.lookup[ihash] == 0)
     {
-      if(uBank[ibank].rocID == rocID)
+      if(simpleGlobalConfig.nubanks >= SIMPLE_MAX_BANKS)
 	{
-	  if(uBank[ibank].header.bf.tag == tag)
-	    {
-	      return ibank;
-	    }
+	  printf("%s: ERROR: Unable to configure more than %d banks\n",
+		 __func__, SIMPLE_MAX_BANKS);
+	  return ERROR;
 	}
-    }
 
-  return -1;
-}
+      simpleGlobalConfig.lookup[ihash] = ++simpleGlobalConfig.nubanks;
+    }
 
-int
-simpleConfigIgnoreUndefinedBlocks(int ignore)
-{
-  if(ignore>=0)
-    ignoreUndefinedBanks=1;
-  else
-    ignoreUndefinedBanks=0;
+  ub = &simpleGlobalConfig.uBank[simpleGlobalConfig.lookup[ihash] - 1];
 
-  printf("%s: INFO: Ignoring undefined banks.\n",__FUNCTION__);
+  ub->rocID             = rocID;
+  ub->header.bf.tag     = bankID;
+  ub->header.bf.num     = num;
+  ub->endian            = endian;
+  ub->isBlocked         = isBlocked;
+  ub->firstPassRoutine  = firstPassRoutine;
 
   return OK;
 }
 
+/**
+ * @ingroup Config
+ * @brief Byte swap a whole big endian bank at once, instead of each word
+ *        as it is scanned.
+ *
+ *    The bank is swapped with the SIMD swap kernel before it is scanned.
+ *    The scan and every accessor then work in native order, so the
+ *    data returned by simpleGetSlotEventData() does not need to be
+ *    swapped again.
+ *
+ *    With SIMPLE_SWAP_INPLACE, the event buffer itself is modified.
+ *    Scan it only once.  With SIMPLE_SWAP_BUFFER, the bank is written to
+ *    the buffer from simpleCtxSetSwapBuffer(), and the event buffer is
+ *    left alone.  If that buffer is missing or full, the bank is swapped
+ *    word by word while scanning, as with SIMPLE_SWAP_NONE.
+ *
+ * @param rocID     roc ID
+ * @param bankID    Bank ID, already configured with simpleConfigBank(), endian = 1
+ * @param swapMode  SIMPLE_SWAP_NONE, SIMPLE_SWAP_INPLACE, or SIMPLE_SWAP_BUFFER
+ *
+ * @return OK if successful, otherwise ERROR
+ */
 int
-simpleScan(volatile unsigned int *data, int nwords)  // FIXME: Not using nwords
+simpleConfigBankSwap(int rocID, int bankID, int swapMode)
 {
-  int iroc = 0, ibank=0;
-
-  memset((char *) &trigBank, 0, sizeof(trigBank));
-  memset((char *) rocBank, 0, sizeof(rocBank));
-  memset((char *) bankData, 0, sizeof(bankData));
-
-  dataAddr = (unsigned long) data;
+  int ibank;
 
-  /* Scan over to get Bank indices.. */
-  if(simpleDebugMask & SIMPLE_SHOW_UNBLOCK)
+  if((swapMode < SIMPLE_SWAP_NONE) || (swapMode > SIMPLE_SWAP_BUFFER))
     {
-      printf("%s: Scan CODA Event for Banks\n",__FUNCTION__);
+      printf("%s: ERROR: Invalid swapMode (%d)\n", __func__, swapMode);
+      return ERROR;
     }
-  simpleScanCodaEvent(data);
 
-  if(simpleDebugMask & SIMPLE_SHOW_UNBLOCK)
+  ibank = simpleFindConfigBankIndex(&simpleGlobalConfig, rocID, bankID);
+  if(ibank >= 0)
     {
-      printf("%s: Start Banks for Events\n",__FUNCTION__);
+      simpleGlobalConfig.uBank[ibank].swapMode = swapMode;
+      return OK;
     }
 
-  /* Scan over to get event indices */
-  for(iroc=0; iroc<SIMPLE_MAX_ROCS; iroc++)
-    {
-      /* Check if the rocBank exists */
-      if((rocBank[iroc].length > 0))
-	{
-	  for(ibank=0; ibank<SIMPLE_MAX_BANKS; ibank++)
-	    {
-	      /* Check if the dataBank for that ROC exists */
-	      if((rocBank[iroc].dataBank[ibank].length > 0))
-		{
-		  /* Scan it */
-		  simpleScanBank(data, iroc, ibank);
-		}
-	    }
-	}
-    }
+  printf("%s: ERROR: rocID = %d, bankID = 0x%x not configured\n",
+	 __func__, rocID, bankID);
 
-  return OK;
+  return ERROR;
 }
 
 /**
- * @ingroup Unblock
- * @brief Pass over the CODA event to determine Bank types and indicies
+ * @ingroup Config
+ * @brief Set the module header that starts a bank in a ROC bank of uint32s
  *
- * @param data Memory address of the data
+ *    Some ROCs write their modules' data as one flat bank of uint32s
+ *    (EVIO_UINT32), instead of a bank of banks.  The ROC bank is split
+ *    into banks at the words where (word & header_mask) == module_header,
+ *    and each is then indexed as a bank with bankID.  The header word is
+ *    the first word of the bank.  With endian = 1, the word is swapped
+ *    before it is compared.
+ *
+ *    e.g. fADC250 block headers (any slot):
+ *      simpleConfigBankHeader(rocID, 3, 0x80000000 | (MODID_FA250 << 18), 0xF83C0000);
+ *
+ * @param rocID          roc ID
+ * @param bankID         Bank ID, already configured with simpleConfigBank()
+ * @param module_header  Value of the header word, under header_mask
+ * @param header_mask    Bits of the word to compare
  *
  * @return OK if successful, otherwise ERROR
  */
 int
-simpleScanCodaEvent(volatile unsigned int *data)
+simpleConfigBankHeader(int rocID, int bankID, unsigned int module_header,
+		       unsigned int header_mask)
 {
-  int iword=0, nwords=0;
-  bankHeader_t bh;
-  int bank_type=0;
-
-  /* First word should be the length of the CODA event */
-  nwords = data[iword++];
-  /* Next word should be the CODA Event header */
-  bh.raw = data[iword++];
+  int ibank;
 
-  if(bh.bf.type == EVIO_BANK)
+  if((module_header & ~header_mask) != 0)
     {
-      /* Hopefully this is the start of the trigger bank */
-      trigBank.length = data[iword++];
-      trigBank.header.raw = data[iword++];
-      trigBank.index = iword;
-
-      if(trigBank.header.bf.type == EVIO_SEGMENT)
-	{
-	  if(simpleDebugMask & SIMPLE_SHOW_BANK_FOUND)
-	    {
-	      printf("[%6d  0x%08x] TRGB 0x%4x: Length = %d, nrocs = %d\n",
-		     trigBank.index - 1, trigBank.header.raw,
-		     trigBank.header.bf.type,
-		     trigBank.length,
-		     trigBank.header.bf.num);
-
-	    }
-	}
-      else
-	{
-	  printf("%s: ERROR: 0x%08x Unexpected bank type 0x%x (%d)\n",
-		 __func__, trigBank.header.raw,
-		 trigBank.header.bf.type,
-		 trigBank.header.bf.type);
-
-	  return ERROR;
-	}
-
-      /* init number of rocs */
-      trigBank.nrocs = 0;
-      /* Index each trigger segment */
-      while(iword < (trigBank.index + trigBank.length - 1))
-	{
-	  segmentHeader_t sh;
-	  sh.raw = data[iword++];
+      printf("%s: ERROR: module_header 0x%08x has bits outside header_mask 0x%08x\n",
+	     __func__, module_header, header_mask);
+      return ERROR;
+    }
 
-	  if(simpleDebugMask & SIMPLE_SHOW_SEGMENT_FOUND)
-	    {
-	      printf("[%6d  0x%08x] SEGM %2d: type = 0x%x, length = %d\n",
-		     iword - 1, sh.raw,
-		     sh.bf.tag,
-		     sh.bf.type,
-		     sh.bf.num);
-	    }
+  ibank = simpleFindConfigBankIndex(&simpleGlobalConfig, rocID, bankID);
+  if(ibank >= 0)
+    {
+      simpleGlobalConfig.uBank[ibank].module_header = module_header;
+      simpleGlobalConfig.uBank[ibank].header_mask   = header_mask;
+      return OK;
+    }
 
-	  switch(sh.bf.type)
-	    {
-	    case EVIO_ULONG64:	  /* Event number ( + timestamp) segment */
-	      {
-		trigBank.segTime.index = iword;
-		trigBank.segTime.header.raw = sh.raw;
-		break;
-	      }
-	    case EVIO_USHORT16:	  /* Event type segment */
-	      {
-		trigBank.segEvType.index = iword;
-		trigBank.segEvType.header.raw = sh.raw;
-		break;
-	      }
-	    case EVIO_UINT32:	  /* ROC segment */
-	      {
-		trigBank.segRoc[sh.bf.tag].index = iword;
-		trigBank.segRoc[sh.bf.tag].header.raw = sh.raw;
-		trigBank.nrocs++;
-		break;
-	      }
+  printf("%s: ERROR: rocID = %d, bankID = 0x%x not configured\n",
+	 __func__, rocID, bankID);
 
-	    default:
-	      printf("%s: ERROR: [0x%08x] Unexpected Segment tag 0x%x (%d) in trigger bank\n",
-		     __func__, sh.raw, sh.bf.tag, sh.bf.tag);
-	      return ERROR;
-	    }
+  return ERROR;
+}
 
-	  /* Move past this segment */
-	  iword += sh.bf.num;
-	}
-    }
-  else
+/**
+ * @ingroup Config
+ * @brief Only index the banks configured with simpleConfigBank()
+ *
+ *    Other data banks are stepped over when the CODA event is scanned.
+ *    They are not indexed, not returned by the data access routines, and
+ *    counted in simpleGetSkipCounts().
+ *
+ * @param ignore  1 to ignore banks that are not configured, 0 to index every bank
+ *
+ * @return OK
+ */
+int
+simpleConfigIgnoreUndefinedBlocks(int ignore)
+{
+  if(ignore > 0)
     {
-      printf("%s: ERROR: 0x%08x Unexpected Bank type 0x%x (%d)\n",
-	     __func__, bh.raw, bh.bf.type, bh.bf.type);
-      return ERROR;
+      simpleGlobalConfig.ignoreUndefinedBanks=1;
+      printf("%s: INFO: Ignoring undefined banks.\n",__FUNCTION__);
     }
+  else
+    simpleGlobalConfig.ignoreUndefinedBanks=0;
 
-  /* ROC Banks start here */
-  while(iword<nwords)
-    {
-      bankHeader_t rocBankHeader;
-      int rocBankLength = 0, rocID = 0;
-
-      /* Index the ROC bank header */
-      rocBankLength = data[iword++] - 1;
-      rocBankHeader.raw = data[iword++];
+  return OK;
+}
 
-      rocID = rocBankHeader.bf.tag & 0x0FFF;
+/**
+ * @ingroup Config
+ * @brief Create a scan context.
+ *
+ *    Each context holds the index of one CODA event, so separate
+ *    threads may scan and access events with their own context.
+ *    Contexts share the bank configuration from simpleConfigBank()
+ *    read-only.  Finish the configuration before scanning.
+ *
+ * @return Address of the new context if successful, otherwise NULL
+ */
+simpleCtx *
+simpleCtxCreate()
+{
+  simpleCtx *ctx;
 
-      if(rocID > SIMPLE_MAX_ROCS)
-	{
-	  printf("%s: ERROR: rocID = %d. I cant handle rocIDs > %d\n",
-		 __func__, rocID, SIMPLE_MAX_ROCS);
-	  return ERROR;
-	}
+  ctx = (simpleCtx *) calloc(1, sizeof(simpleCtx));
+  if(ctx == NULL)
+    {
+      printf("%s: ERROR: Unable to allocate scan context\n", __func__);
+      return NULL;
+    }
 
-      rocBank[rocID].header.raw = rocBankHeader.raw;
-      rocBank[rocID].index = iword;
-      rocBank[rocID].length = rocBankLength;
+  ctx->config = &simpleGlobalConfig;
+  ctx->debugMask = simpleDebugMask;
+  ctx->validate = simpleValidateLevel;
+  ctx->stats = simpleStatsEnable;
+  ctx->errorPrintRate = simpleErrorPrintRate;
+  ctx->ringWrap = INT_MAX;
+  ctx->bankPool.elsize = sizeof(bankDataInfo);
+  ctx->slotPool.elsize = sizeof(slotDataInfo);
 
-      if(simpleDebugMask & SIMPLE_SHOW_BANK_FOUND)
-	{
-	  printf("[%6d  0x%08x] ROCB %2d: type = 0x%2x, Length = %d, blocklevel = %d\n",
-		 rocBank[rocID].index - 1, rocBank[rocID].header.raw,
-		 rocID,
-		 rocBank[rocID].header.bf.type,
-		 rocBank[rocID].length,
-		 rocBank[rocID].header.bf.num);
-	}
+  if(simpleTraceRecords && (simpleCtxConfigTrace(ctx, simpleTraceRecords) != OK))
+    {
+      free(ctx);
+      return NULL;
+    }
 
-      switch(rocBank[rocID].header.bf.type)
-	{
-	case EVIO_BANK: /* Roc Bank is a Bank of Banks */
-	  {
-	    rocBank[rocID].nbanks = 0;
+  return ctx;
+}
 
-	    /* Inside the ROC bank.
-	       Look for data banks and determine their lengths and indices */
-	    while(iword < (rocBank[rocID].index + rocBank[rocID].length - 1))
-	      {
-		bankHeader_t dataBankHeader;
-		int dataBankLength = 0, dataBankID = 0, dataBankIndex = 0;
-
-		dataBankLength = data[iword++] - 1;
-		dataBankHeader.raw = data[iword++];
-		dataBankIndex  = iword;
-		dataBankID = dataBankHeader.bf.tag;
-
-		/* We save the bank header and length in the struct,
-		   so .index and .length here refer to the data inside */
-		rocBank[rocID].dataBank[dataBankID].length = dataBankLength;
-		rocBank[rocID].dataBank[dataBankID].index  = dataBankIndex;
-		rocBank[rocID].dataBank[dataBankID].header.raw = dataBankHeader.raw;
-		rocBank[rocID].nbanks++;
-
-#ifdef FIGUREITOUT
-		if(ignoreUndefinedBanks)
-		  {
-		    // FIXME: need to check vs configured banks
-		    if( rocBank[rocID].dataBank[dataBankID].ID )
-		      {
-			if(simpleDebugMask & SIMPLE_SHOW_IGNORED_BANKS)
-			  {
-			    printf("[%6d  0x%08x] IGNORED BANK 0x%2x: Type = 0x%x Num = 0x%x Length = %d\n",
-				   dataBankIndex - 1, dataBankHeader.raw,
-				   rocBank[rocID].dataBank[dataBankID].header.bf.tag,
-				   rocBank[rocID].dataBank[dataBankID].header.bf.type,
-				   rocBank[rocID].dataBank[dataBankID].header.bf.num,
-				   rocBank[rocID].dataBank[dataBankID].length);
-			  }
-
-			/* Jump to next bank */
-			iword += rocBank[rocID].dataBank[dataBankID].length;
-			continue;
-		      }
-		  }
-#endif
+static void
+simplePoolFree(simplePool *pool)
+{
+  int ichunk;
 
-		if(simpleDebugMask & SIMPLE_SHOW_BANK_FOUND)
-		  {
-		    printf("[%6d  0x%08x] BANK 0x%2x: Type = 0x%x Num = 0x%x Length = %d\n",
-			   dataBankIndex - 1, dataBankHeader.raw,
-			   rocBank[rocID].dataBank[dataBankID].header.bf.tag,
-			   rocBank[rocID].dataBank[dataBankID].header.bf.type,
-			   rocBank[rocID].dataBank[dataBankID].header.bf.num,
-			   rocBank[rocID].dataBank[dataBankID].length);
-		  }
+  for(ichunk = 0; ichunk < pool->nchunks; ichunk++)
+    free(pool->chunk[ichunk]);
+  free(pool->chunk);
 
-		/* Jump to next bank */
-		iword += rocBank[rocID].dataBank[dataBankID].length;
-	      }
-	    break;
-	  }
+  pool->chunk = NULL;
+  pool->nchunks = 0;
+  pool->nused = 0;
 
-	case EVIO_UINT32:  /* Roc Bank is a Bank of uint32s, skipped for now */
-	  {
-	    printf("%s: ERROR: Bank type 0x%x not supported\n",
-		   __FUNCTION__,bank_type);
-	    return ERROR;
-	    /* If there are Lengths and Headers defined by the user, use them to find the
-	       indicies */
-	    while(iword<nwords)
-	      {
-		/* FIXME: Will do this later... */
-	      }
+  for(ichunk = 0; ichunk < pool->nevtChunks; ichunk++)
+    free(pool->evtChunk[ichunk]);
+  free(pool->evtChunk);
 
-	    break;
-	  }
+  pool->evtChunk = NULL;
+  pool->nevtChunks = 0;
+  pool->evtChunkUsed = 0;
+  pool->evtUsed = 0;
+}
 
-	default:
-	  printf("%s: ERROR: Bank type 0x%x not supported\n",
-		 __FUNCTION__,bank_type);
-	  return ERROR;
-	}
+/* Return everything taken from the pool, keeping its memory */
+static void
+simplePoolReset(simplePool *pool)
+{
+  pool->nused = 0;
+  pool->evtChunkUsed = 0;
+  pool->evtUsed = 0;
+}
 
-    }
-  return OK;
+/**
+ * @ingroup Config
+ * @brief Free a scan context, and everything it has indexed.
+ *
+ * @param ctx Scan context from simpleCtxCreate()
+ */
+void
+simpleCtxDestroy(simpleCtx *ctx)
+{
+  if((ctx == NULL) || (ctx == &simpleDefaultCtx))
+    return;
+
+  simpleCtxConfigParallelBanks(ctx, 0);
+  simpleCtxConfigTrace(ctx, 0);
+
+  simplePoolFree(&ctx->bankPool);
+  simplePoolFree(&ctx->slotPool);
+  free(ctx->bankHash);
+  free(ctx->eventSlot);
+  free(ctx->skipCount);
+  free(ctx->bankStats);
+  free(ctx->syncBank);
+  free(ctx);
 }
 
 /**
- * @ingroup Unblock
- * @brief Scan through a ROC's bank to determine Event header indicies
+ * @ingroup Config
+ * @brief Scan the data banks of each event in parallel.
  *
- *    This is the default method, if one is not specified with
- *    simpleConfigModule.  It uses the JLab Data Format Standard
+ *    simpleCtxScan() hands the banks found by simpleCtxScanCodaEvent() to a
+ *    pool of persistent threads, to lower the latency of indexing one large
+ *    event.  The calling thread also scans banks, so nthreads = 3 uses up
+ *    to 4 cores.
  *
- * @param data       Memory address of the data
- * @param rocID      Which ROC bank to find the Bank
- * @param bankNumber Which Bank to index.
+ * @param ctx       Scan context
+ * @param nthreads  Number of threads to add to the calling thread.
+ *                  0 to scan serially (default).
  *
  * @return OK if successful, otherwise ERROR
  */
-
 int
-simpleScanBank(volatile unsigned int *data, int rocID, int bankNumber)
+simpleCtxConfigParallelBanks(simpleCtx *ctx, int nthreads)
 {
-  int rval=OK;
-  int iword=0; /* Index of current word in *data */
-  int current_event=0;
-  int nwords = 0;
-  int blkCounter=0; /* count of blocks within the data (one per module) */
-  unsigned int slotNumber = 0; /* Set in block header, checked in block trailer */
-  int userBankIndex;
-  int endian = 0;
-  jlab_data_word_t jdata;
-  block_header_t bheader;
-  block_trailer_t btrailer;
-  event_header_t eheader;
-  scaler_header_t sheader;
+  int iworker, nworkers;
 
-  blkCounter = 0;
+  if(nthreads < 0)
+    {
+      printf("%s: ERROR: Invalid nthreads (%d)\n", __func__, nthreads);
+      return ERROR;
+    }
 
-  /* Check if this rocID and bankNumber combo were found in simpleScanCodaEvent */
-  if( ((rocBank[rocID].header.bf.tag & 0x0FFF) != rocID) ||
-      (rocBank[rocID].dataBank[bankNumber].header.bf.tag != bankNumber) )
+  if(ctx->taskPool)
     {
-      if(simpleDebugMask & SIMPLE_SHOW_BANK_NOT_FOUND)
-	{
-	  printf("%s: rocID = 0x%x, bankNumber = 0x%x NOT found\n",
-		 __func__, rocID, bankNumber);
-	}
-      return -1;
+      nworkers = simpleTaskPoolWorkers(ctx->taskPool);
+      simpleTaskPoolDestroy(ctx->taskPool);
+      ctx->taskPool = NULL;
+
+      for(iworker = 0; iworker < nworkers; iworker++)
+	simplePoolFree(&ctx->taskSlotPool[iworker]);
+      free(ctx->taskSlotPool);
+      ctx->taskSlotPool = NULL;
+
+      free(ctx->taskBank);
+      ctx->taskBank = NULL;
+      ctx->taskBankSize = 0;
     }
 
-  iword = rocBank[rocID].dataBank[bankNumber].index;
-  nwords = iword + rocBank[rocID].dataBank[bankNumber].length;
+  if(nthreads == 0)
+    return OK;
 
-  bankData[rocID][bankNumber].rocID = rocID;
-  bankData[rocID][bankNumber].bankID = bankNumber;
+  nworkers = nthreads + 1;
+  ctx->taskSlotPool = (simplePool *) calloc(nworkers, sizeof(simplePool));
+  if(ctx->taskSlotPool == NULL)
+    return ERROR;
+  for(iworker = 0; iworker < nworkers; iworker++)
+    ctx->taskSlotPool[iworker].elsize = sizeof(slotDataInfo);
 
-  userBankIndex = simpleFindConfigBankIndex(rocID, bankNumber);
-  if(userBankIndex >= 0)
+  ctx->taskPool = simpleTaskPoolCreate(nthreads);
+  if(ctx->taskPool == NULL)
     {
-      if(!uBank[userBankIndex].isBlocked)
-	return 0;
-
-      endian = uBank[userBankIndex].endian;
+      printf("%s: ERROR: Unable to create pool of %d threads\n", __func__, nthreads);
+      free(ctx->taskSlotPool);
+      ctx->taskSlotPool = NULL;
+      return ERROR;
     }
 
-  /* Index the Bank of Data.
-     Looking for Block Headers, Event headers, and Block Trailers  */
-  while(iword<nwords)
-    {
-      jdata.raw = data[iword];
-      if(endian)
-	jdata.raw = bswap_32(jdata.raw);
-
-      if(jdata.bf.data_type_defining == 1)
-	{
-	  switch(jdata.bf.data_type_tag)
-	    {
-	    case BLOCK_HEADER: /* 0: BLOCK HEADER */
-	      {
-		bheader.raw = jdata.raw;
-
-		blkCounter++; /* Increment block counter */
+  return OK;
+}
 
-		bankData[rocID][bankNumber].evtCounter = 0; /* Initialize the event counter */
-		slotNumber = bheader.bf.slot_number;
+/**
+ * @ingroup Config
+ * @brief Index data banks only when they are first accessed.
+ *
+ *    simpleCtxScan() then only finds the trigger bank, ROC banks and data
+ *    banks of the event.  A data bank is indexed (and swapped) by the first
+ *    data access routine asking for it, so banks that are never read cost
+ *    nothing.  simpleCtxGetEvent() indexes every bank.
+ *
+ *    What changes for the caller:
+ *    - The event buffer (also the ring of simpleCtxScanRing(), and the
+ *      buffer of simpleCtxStreamStart()) must stay valid and unchanged
+ *      until the last data access of the event.
+ *    - A SIMPLE_SWAP_INPLACE bank is swapped in the event buffer by the
+ *      first access to it, not by the scan.
+ *    - Data access routines write the index into the context, so one
+ *      context may not be read from more than one thread at a time.
+ *    - Errors in a data bank are recorded (simpleCtxGetErrors()) when it
+ *      is indexed, and are not seen by simpleCtxScan().
+ *    - simpleCtxConfigParallelBanks() has no effect: each bank is indexed
+ *      by the thread accessing it.
+ *
+ * @param ctx   Scan context
+ * @param lazy  1 to index on access, 0 to index every bank in the scan (default)
+ *
+ * @return OK
+ */
+int
+simpleCtxConfigLazy(simpleCtx *ctx, int lazy)
+{
+  ctx->lazy = lazy ? 1 : 0;
 
-		bankData[rocID][bankNumber].blkIndex[slotNumber] = iword;
-		bankData[rocID][bankNumber].blkLevel   = bheader.bf.number_of_events_in_block;
+  return OK;
+}
 
-		if(simpleDebugMask & SIMPLE_SHOW_BLOCK_HEADER)
-		  {
-		    printf("[%6d  0x%08x] "
-			   "BLOCK HEADER: slot %2d, block_number %3d, block_level %3d\n",
-			   iword,
-			   bheader.raw,
-			   bheader.bf.slot_number,
-			   bheader.bf.event_block_number,
-			   bheader.bf.number_of_events_in_block);
-		  }
-		break;
-	      }
-
-	    case BLOCK_TRAILER: /* 1: BLOCK TRAILER */
-	      {
-		btrailer.raw = jdata.raw;
-		bankData[rocID][bankNumber].blkTrailerIndex[slotNumber] = iword;
-
-		if(simpleDebugMask & SIMPLE_SHOW_BLOCK_TRAILER)
-		  {
-		    printf("[%6d  0x%08x] "
-			   "BLOCK TRAILER: slot %2d, nwords %d\n",
-			   iword,
-			   btrailer.raw,
-			   btrailer.bf.slot_number,
-			   btrailer.bf.words_in_block);
-		  }
-
-		/* Obtain the previous event length */
-		if(bankData[rocID][bankNumber].evtCounter > 0)
-		  {
-		    current_event = bankData[rocID][bankNumber].evtCounter - 1;
-
-		    bankData[rocID][bankNumber].evtLength[slotNumber][current_event] =
-		      iword - bankData[rocID][bankNumber].evtIndex[slotNumber][current_event];
-		  }
-
-		/* Check the slot number to make sure this block
-		   trailer is associated with the previous block
-		   header */
-		if(btrailer.bf.slot_number != slotNumber)
-		  {
-		    printf("[%6d  0x%08x] "
-			   "ERROR: blockheader slot %d != blocktrailer slot %d\n",
-			   iword,
-			   btrailer.raw,
-			   slotNumber,
-			   btrailer.bf.slot_number);
-		    rval = ERROR;
-		  }
-
-		/* Check the number of words vs. words counted within the block */
-		if(btrailer.bf.words_in_block !=
-		   (iword - bankData[rocID][bankNumber].blkIndex[slotNumber]+1) )
-		  {
-		    printf("[%6d  0x%08x] "
-			   "ERROR: trailer #words %d != actual #words %d\n",
-			   iword,
-			   btrailer.raw,
-			   btrailer.bf.words_in_block,
-			   iword-bankData[rocID][bankNumber].blkIndex[slotNumber]+1);
-		    rval = ERROR;
-		  }
-
-		slotNumber = 0; /* Initialize for next block */
-		break;
-	      }
-
-	    case EVENT_HEADER: /* 2: EVENT HEADER */
-	      {
-		eheader.raw = jdata.raw;
-
-		if(simpleDebugMask & SIMPLE_SHOW_EVENT_HEADER)
-		  {
-		    printf("[%6d  0x%08x] "
-			   "EVENT HEADER: trigger number %d\n",
-			   iword,
-			   eheader.raw,
-			   eheader.bf.event_number);
-
-		  }
-
-		if(slotNumber == 0)
-		  {
-		    printf("%s: ERROR.  Event Header Found. Slot Number = 0.\n",
-			   __func__);
-		    return ERROR;
-		  }
-
-		/* Add this slot to the slotMask */
-		bankData[rocID][bankNumber].slotMask |= (1 << slotNumber);
-
-		/* Obtain the previous event length */
-		if(bankData[rocID][bankNumber].evtCounter > 0)
-		  {
-		    current_event = bankData[rocID][bankNumber].evtCounter - 1;
-
-		    bankData[rocID][bankNumber].evtLength[slotNumber][current_event] =
-		      iword - bankData[rocID][bankNumber].evtIndex[slotNumber][current_event];
-		  }
-
-		bankData[rocID][bankNumber].evtCounter++; /* increment event counter */
-		current_event = bankData[rocID][bankNumber].evtCounter - 1;
-		bankData[rocID][bankNumber].evtIndex[slotNumber][current_event] = iword;
-
-		break;
-	      }
-
-	    case SCALER_HEADER: /* 12: SCALER_HEADER */
-	      {
-		sheader.raw = jdata.raw;
-
-		if(simpleDebugMask & SIMPLE_SHOW_SCALER_HEADER)
-		  {
-		    printf("[%6d  0x%08x] "
-			   "SCALER HEADER: scaler_words = %d\n",
-			   iword,
-			   jdata.raw, sheader.bf.scaler_words);
-
-		  }
-
-		iword += sheader.bf.scaler_words;
-	      }
-
-	    default:
-	      /* Ignore all other data types for now */
-	      if(simpleDebugMask & SIMPLE_SHOW_OTHER)
-		{
-		  printf("(%3d) OTHER: 0x%08x\n",iword,data[iword]);
-		}
-	    } /* switch(data_type) */
-
-	} /* if(jdata.bf.data_type_defining == 1) */
-
-      iword++;
-
-    } /* while(iword<nwords) */
-
-  return rval;
-}
-
-#define CHECKROCID(x,y)				\
-  {						\
-    if(bankData[x][y].rocID != x)		\
-      return -1;				\
-  }
-
-
-/* Data access routines */
+/**
+ * @ingroup Config
+ * @brief Index data banks of the default context only when first accessed.
+ */
 int
-simpleGetRocBanks(int rocID, int bankID, int *bankList)
+simpleConfigLazy(int lazy)
 {
-  CHECKROCID(rocID,bankID);
-
-  return 0;
+  return simpleCtxConfigLazy(&simpleDefaultCtx, lazy);
 }
 
 /**
- * @ingroup Data Access
- * @brief Return the slotmask from the specified rocID and bankID
+ * @ingroup Config
+ * @brief Set how much of the event is checked while it is scanned.
  *
- * @param rocID      Which ROC bank to find the slotmask
- * @param bankID     Which Bank to find the slotmask
- * @param *slotmask  Where to store the slotmask
+ *    Every level keeps the scan inside the event (and the nwords given to
+ *    simpleCtxScan()), and inside the length of each bank and segment.
  *
- * @return 1 if successful, otherwise ERROR
+ *    SIMPLE_VALIDATE_OFF   Nothing more
+ *    SIMPLE_VALIDATE_FAST  Banks and segments also fill their parents exactly
+ *    SIMPLE_VALIDATE_FULL  The bank scan also checks each block trailer's
+ *                          word count and slot, and the number of events
+ *                          of each block (default)
+ *
+ * @param ctx    Scan context
+ * @param level  SIMPLE_VALIDATE_OFF, SIMPLE_VALIDATE_FAST, or SIMPLE_VALIDATE_FULL
+ *
+ * @return OK if successful, otherwise ERROR
  */
-
 int
-simpleGetRocSlotmask(int rocID, int bankID, unsigned int *slotmask)
+simpleCtxConfigValidate(simpleCtx *ctx, int level)
 {
-  CHECKROCID(rocID,bankID);
+  if((level < SIMPLE_VALIDATE_OFF) || (level > SIMPLE_VALIDATE_FULL))
+    {
+      printf("%s: ERROR: Invalid validation level (%d)\n", __func__, level);
+      return ERROR;
+    }
 
-  *slotmask = bankData[rocID][bankID].slotMask;
+  ctx->validate = level;
 
-  return 1;
+  return OK;
 }
 
 /**
- * @ingroup Data Access
- * @brief Return the buffer to the part of the data with specified rocID,
- *         bankID.  Use for unblocked Banks.
- *
- * @param rocID        Which ROC bank to find the buffer
- * @param bankID       Which Bank to find the buffer
- * @param **buffer     Where to store the address of the buffer
- *
- * @return Length of the buffer if successful, otherwise ERROR
+ * @ingroup Config
+ * @brief Set the validation level of the default context, and of the
+ *    contexts created after this call.
  */
-
 int
-simpleGetRocBankData(int rocID, int bankID, unsigned int **buffer)
+simpleConfigValidate(int level)
 {
-  int length = 0;
-  unsigned long addr = 0;
-
-  CHECKROCID(rocID, bankID);
-
-  addr = (unsigned long)((unsigned int *)dataAddr + rocBank[rocID].dataBank[bankID].index);
-  *buffer = (unsigned int *) addr;
+  if(simpleCtxConfigValidate(&simpleDefaultCtx, level) != OK)
+    return ERROR;
 
-  length = rocBank[rocID].dataBank[bankID].length;
+  simpleValidateLevel = level;
 
-  return length;
+  return OK;
 }
 
 /**
- * @ingroup Data Access
- * @brief Return the block level from the specified rocID and bankID
+ * @ingroup Config
+ * @brief Count and time the scans of a context, for simpleCtxGetStats()
+ *    and simpleCtxGetBankStats().  Off by default.  The library must be
+ *    built with SIMPLE_STATS (make STATS=1, the default) to count them.
  *
- * @param rocID        Which ROC bank to find the block level
- * @param bankID       Which Bank to find the block level
- * @param *blockLevel  Where to store the block level
+ * @param ctx     Scan context
+ * @param enable  1 to count, 0 to stop (the counts are kept)
  *
- * @return 1 if successful, otherwise ERROR
+ * @return OK if successful, otherwise ERROR
  */
-
 int
-simpleGetRocBlockLevel(int rocID, int bankID, int *blockLevel)
+simpleCtxConfigStats(simpleCtx *ctx, int enable)
 {
-  CHECKROCID(rocID, bankID);
+#ifndef SIMPLE_STATS
+  if(enable)
+    {
+      printf("%s: ERROR: Library built without SIMPLE_STATS\n", __func__);
+      return ERROR;
+    }
+#endif
 
-  *blockLevel = bankData[rocID][bankID].blkLevel;
+  ctx->stats = enable ? 1 : 0;
 
-  return 1;
+  return OK;
 }
 
 /**
- * @ingroup Data Access
- * @brief Return the block header from the specified rocID, bankID, and slot number
- *
- * @param rocID        Which ROC bank to find the block header
- * @param bankID       Which Bank to find the block header
- * @param slot         Which slot to find the block header
- * @param *header      Where to store the block header
- *
- * @return 1 if successful, otherwise ERROR
+ * @ingroup Config
+ * @brief Count and time the scans of the default context, and of the
+ *    contexts created after this call.
  */
-
 int
-simpleGetSlotBlockHeader(int rocID, int bankID, int slot, unsigned int *header)
+simpleConfigStats(int enable)
 {
-  int index;
-  unsigned int *bufPtr = (unsigned int *)dataAddr;
-
-  CHECKROCID(rocID, bankID);
-
-  if( (bankData[rocID][bankID].slotMask & (1 << slot)) == 0 )
-     return -1;
+  if(simpleCtxConfigStats(&simpleDefaultCtx, enable) != OK)
+    return ERROR;
 
-  index = bankData[rocID][bankID].blkIndex[slot];
-  *header = bufPtr[index];
+  simpleStatsEnable = enable ? 1 : 0;
 
-  return 1;
+  return OK;
 }
 
-
 /**
- * @ingroup Data Access
- * @brief Return the Event header from the specified rocID, bankID, and slot
- *        for the specified event within a block
+ * @ingroup Config
+ * @brief Record what the scans of a context find (banks, segments, block
+ *    headers, event headers, ...) in a ring buffer of trace records, for
+ *    simpleCtxGetTrace().  The oldest records are overwritten.  The
+ *    library must be built with SIMPLE_TRACE (make TRACE=1, the default
+ *    with DEBUG).  Without it, the tracing and the SIMPLE_SHOW_BLOCK_HEADER
+ *    to SIMPLE_SHOW_SCALER_HEADER output of the scan are compiled out.
  *
- * @param rocID        Which ROC bank to find the event header
- * @param bankID       Which Bank to find the event header
- * @param slot         Which slot to find the event header
- * @param evt          Which event within the block to find the event header
- * @param *header  Where to store the event header
+ * @param ctx       Scan context
+ * @param nrecords  Size of the ring buffer, rounded up to a power of 2.
+ *                  0 to stop tracing, and free it.
  *
- * @return 1 if successful, otherwise ERROR
+ * @return OK if successful, otherwise ERROR
  */
-
 int
-simpleGetSlotEventHeader(int rocID, int bankID, int slot, int evt, unsigned int *header)
+simpleCtxConfigTrace(simpleCtx *ctx, int nrecords)
 {
-  int index;
-  unsigned int *bufPtr = (unsigned int *)dataAddr;
+  simpleTrace *trace;
+  unsigned int size = 1;
 
-  CHECKROCID(rocID, bankID);
+  if(nrecords < 0)
+    {
+      printf("%s: ERROR: Invalid number of records (%d)\n", __func__, nrecords);
+      return ERROR;
+    }
+
+#ifndef SIMPLE_TRACE
+  if(nrecords)
+    {
+      printf("%s: ERROR: Library built without SIMPLE_TRACE\n", __func__);
+      return ERROR;
+    }
+#endif
+
+  if(ctx->trace)
+    {
+      free(ctx->trace->record);
+      free(ctx->trace);
+      ctx->trace = NULL;
+    }
 
-  if( (bankData[rocID][bankID].slotMask & (1 << slot)) == 0 )
-     return -1;
+  if(nrecords == 0)
+    return OK;
 
-  index = bankData[rocID][bankID].evtIndex[slot][evt];
-  *header = bufPtr[index];
+  while((size < (unsigned int)nrecords) && (size < (1U << 30)))
+    size <<= 1;
 
-  return 1;
+  trace = (simpleTrace *) calloc(1, sizeof(simpleTrace));
+  if(trace)
+    trace->record = (simpleTraceRecord *) calloc(size, sizeof(simpleTraceRecord));
+  if((trace == NULL) || (trace->record == NULL))
+    {
+      printf("%s: ERROR: Unable to allocate %u trace records\n", __func__, size);
+      free(trace);
+      return ERROR;
+    }
+  trace->mask = size - 1;
+
+  ctx->trace = trace;
+
+  return OK;
 }
 
 /**
- * @ingroup Data Access
- * @brief Return the buffer to the part of the data with specified rocID,
- *         bankID, and slot number, and event of the block.
- *
- * @param rocID        Which ROC bank to find the buffer
- * @param bankID       Which Bank to find the buffer
- * @param slot         Which slot to find the buffer
- * @param evt          Which event within the block to find the buffer
- * @param **buffer     Where to store the address of the buffer
- *
- * @return Length of the buffer if successful, otherwise ERROR
+ * @ingroup Config
+ * @brief Trace the scans of the default context, and of the contexts
+ *    created after this call.
  */
-
 int
-simpleGetSlotEventData(int rocID, int bankID, int slot, int evt, unsigned int **buffer)
+simpleConfigTrace(int nrecords)
 {
-  int length = 0;
-  unsigned long addr = 0;
-
-  CHECKROCID(rocID, bankID);
-
-  if( (bankData[rocID][bankID].slotMask & (1 << slot)) == 0 )
-     return -1;
-
-  addr = (unsigned long)((unsigned int *)dataAddr + bankData[rocID][bankID].evtIndex[slot][evt]);
-  *buffer = (unsigned int *) addr;
+  if(simpleCtxConfigTrace(&simpleDefaultCtx, nrecords) != OK)
+    return ERROR;
 
-  length = bankData[rocID][bankID].evtLength[slot][evt];
+  simpleTraceRecords = nrecords;
 
-  return length;
+  return OK;
 }
 
 /**
- * @ingroup Data Access
- * @brief Return the block trailer from the specified rocID, bankID, and slot number
+ * @ingroup Config
+ * @brief How many of the errors found by the scans of a context to print.
+ *    Every error is counted and kept for simpleCtxGetErrors() regardless.
  *
- * @param rocID        Which ROC bank to find the block trailer
- * @param bankID       Which Bank to find the block trailer
- * @param slot         Which slot to find the block trailer
- * @param *trailer     Where to store the block trailer
+ * @param ctx        Scan context
+ * @param perSecond  Most errors printed each second (SIMPLE_ERROR_PRINT_RATE
+ *                   by default).  0 for none, -1 for all of them.
  *
- * @return 1 if successful, otherwise ERROR
+ * @return OK if successful, otherwise ERROR
  */
-
 int
-simpleGetSlotBlockTrailer(int rocID, int bankID, int slot, unsigned int *trailer)
+simpleCtxConfigErrorPrint(simpleCtx *ctx, int perSecond)
 {
-  int index;
-  unsigned int *bufPtr = (unsigned int *)dataAddr;
-
-  CHECKROCID(rocID, bankID);
-
-  if( (bankData[rocID][bankID].slotMask & (1 << slot)) == 0 )
-     return -1;
+  if(perSecond < -1)
+    {
+      printf("%s: ERROR: Invalid errors per second (%d)\n", __func__, perSecond);
+      return ERROR;
+    }
 
-  index = bankData[rocID][bankID].blkTrailerIndex[slot];
-  *trailer = bufPtr[index];
+  ctx->errorPrintRate = perSecond;
 
-  return 1;
+  return OK;
 }
 
 /**
- * @ingroup Data Access
- * @brief Return the buffer to the Trigger Bank's Run number and Timestamp segment
- *
- * @param **buffer     Where to store the address of the buffer
- *
- * @return Length of the buffer if successful, otherwise ERROR
+ * @ingroup Config
+ * @brief How many errors to print, for the default context and the
+ *    contexts created after this call.
  */
-
 int
-simpleGetTriggerBankTimeSegment(unsigned long long **buffer)
+simpleConfigErrorPrint(int perSecond)
 {
-  int len = 0;
-  unsigned long addr = (unsigned long)((unsigned int *)dataAddr + trigBank.segTime.index);
+  if(simpleCtxConfigErrorPrint(&simpleDefaultCtx, perSecond) != OK)
+    return ERROR;
 
-  *buffer = (unsigned long long int *)addr;
-  len = trigBank.segTime.header.bf.num >> 1;
+  simpleErrorPrintRate = perSecond;
 
-  return len;
+  return OK;
 }
 
 /**
- * @ingroup Data Access
- * @brief Return the buffer to the Trigger Bank's Event Type segment
+ * @ingroup Config
+ * @brief Set the buffer that banks configured with SIMPLE_SWAP_BUFFER are
+ *        swapped into.  It holds the swapped banks of one event, until
+ *        the next scan.
  *
- * @param **buffer     Where to store the address of the buffer
+ * @param ctx     Scan context
+ * @param buffer  Address of the buffer, or NULL to stop using one
+ * @param nwords  Size of the buffer, in words
  *
- * @return Length of the buffer if successful, otherwise ERROR
+ * @return OK if successful, otherwise ERROR
  */
-
 int
-simpleGetTriggerBankTypeSegment(unsigned short **buffer)
+simpleCtxSetSwapBuffer(simpleCtx *ctx, unsigned int *buffer, int nwords)
 {
-  int len = 0;
-  unsigned long addr = (unsigned long)((unsigned int *)dataAddr + trigBank.segEvType.index);
+  if((buffer != NULL) && (nwords < 0))
+    {
+      printf("%s: ERROR: Invalid nwords (%d)\n", __func__, nwords);
+      return ERROR;
+    }
 
-  *buffer = (unsigned short *)addr;
-  len = trigBank.segEvType.header.bf.num << 1;
+  ctx->swapBuffer = buffer;
+  ctx->swapBufferSize = buffer ? nwords : 0;
+  ctx->swapBufferUsed = 0;
 
-  return len;
+  return OK;
 }
 
 /**
- * @ingroup Data Access
- * @brief Return the buffer to the Trigger Bank's ROC segment
- *
- * @param rocID        Which roc ID to find the buffer
- * @param **buffer     Where to store the address of the buffer
+ * @ingroup Config
+ * @brief Set the swap buffer of the default context.
+ *        See simpleCtxSetSwapBuffer().
+ */
+int
+simpleSetSwapBuffer(unsigned int *buffer, int nwords)
+{
+  return simpleCtxSetSwapBuffer(&simpleDefaultCtx, buffer, nwords);
+}
+
+/**
+ * @ingroup Config
+ * @brief Scan the data banks of each event in parallel, with the default context.
+ *        See simpleCtxConfigParallelBanks().
+ */
+int
+simpleConfigParallelBanks(int nthreads)
+{
+  return simpleCtxConfigParallelBanks(&simpleDefaultCtx, nthreads);
+}
+
+/**
+ * @ingroup Config
+ * @brief Return the context used by the routines that do not take one.
+ */
+simpleCtx *
+simpleGetDefaultCtx()
+{
+  return &simpleDefaultCtx;
+}
+
+/* Return the next free element of the pool.  Allocated in chunks, so
+   the address of an element does not change as the pool grows. */
+static void *
+simplePoolAlloc(simplePool *pool)
+{
+  int ichunk = pool->nused / SIMPLE_POOL_CHUNK;
+
+  if(ichunk >= pool->nchunks)
+    {
+      char **chunk;
+
+      chunk = (char **) realloc(pool->chunk, (ichunk + 1) * sizeof(char *));
+      if(chunk == NULL)
+	return NULL;
+      pool->chunk = chunk;
+
+      pool->chunk[ichunk] = (char *) malloc(SIMPLE_POOL_CHUNK * pool->elsize);
+      if(pool->chunk[ichunk] == NULL)
+	return NULL;
+      pool->nchunks = ichunk + 1;
+    }
+
+  return pool->chunk[ichunk] + (pool->nused++ % SIMPLE_POOL_CHUNK) * pool->elsize;
+}
+
+/* n entries of event data, n <= SIMPLE_EVT_CHUNK */
+static simpleEventData *
+simplePoolAllocEvents(simplePool *pool, int n)
+{
+  simpleEventData *evt;
+
+  while(pool->evtChunkUsed < pool->nevtChunks)
+    {
+      if(pool->evtUsed + n <= SIMPLE_EVT_CHUNK)
+	{
+	  evt = &pool->evtChunk[pool->evtChunkUsed][pool->evtUsed];
+	  pool->evtUsed += n;
+	  return evt;
+	}
+      pool->evtChunkUsed++;
+      pool->evtUsed = 0;
+    }
+
+  {
+    simpleEventData **chunk;
+
+    chunk = (simpleEventData **) realloc(pool->evtChunk,
+					 (pool->nevtChunks + 1) * sizeof(simpleEventData *));
+    if(chunk == NULL)
+      return NULL;
+    pool->evtChunk = chunk;
+
+    pool->evtChunk[pool->nevtChunks] =
+      (simpleEventData *) malloc(SIMPLE_EVT_CHUNK * sizeof(simpleEventData));
+    if(pool->evtChunk[pool->nevtChunks] == NULL)
+      return NULL;
+    pool->nevtChunks++;
+  }
+
+  pool->evtUsed = n;
+  return pool->evtChunk[pool->evtChunkUsed];
+}
+
+static unsigned int
+simpleBankHashSlot(simpleCtx *ctx, unsigned int key)
+{
+  return (key * 0x9E3779B1u) >> (32 - ctx->bankHashBits);
+}
+
+/**
+ * @ingroup Unblock
+ * @brief Invalidate the bank index from the previous event.
+ *
+ *    Bank and slot entries are returned to their pools, and the
+ *    bank lookup is invalidated by bumping its generation.  The
+ *    cost scales with the number of ROCs found in the previous event.
+ */
+static void
+simpleResetIndex(simpleCtx *ctx)
+{
+  int iroc, rocID;
+
+  for(iroc = 0; iroc < ctx->trigBank.nrocs; iroc++)
+    memset(&ctx->trigBank.segRoc[ctx->trigRocList[iroc]], 0, sizeof(codaSegmentInfo));
+
+  ctx->trigBank.length = 0;
+  ctx->trigBank.header.raw = 0;
+  ctx->trigBank.index = 0;
+  ctx->trigBank.nrocs = 0;
+  memset(&ctx->trigBank.segTime, 0, sizeof(codaSegmentInfo));
+  memset(&ctx->trigBank.segEvType, 0, sizeof(codaSegmentInfo));
+
+  for(iroc = 0; iroc < ctx->nRocs; iroc++)
+    {
+      rocID = ctx->rocList[iroc];
+      ctx->rocBank[rocID].length = 0;
+      ctx->rocBank[rocID].header.raw = 0;
+      ctx->rocBank[rocID].index = 0;
+      ctx->rocBank[rocID].rocID = 0;
+      ctx->rocBank[rocID].nbanks = 0;
+      ctx->rocBank[rocID].found = 0;
+    }
+  ctx->nRocs = 0;
+
+  ctx->ringBase = NULL;
+  ctx->ringWrap = INT_MAX;
+
+  simplePoolReset(&ctx->bankPool);
+  simplePoolReset(&ctx->slotPool);
+  ctx->swapBufferUsed = 0;
+  ctx->eventsBuilt = 0;
+  ctx->nEvents = 0;
+  if(ctx->taskPool)
+    {
+      int iworker;
+      for(iworker = 0; iworker < simpleTaskPoolWorkers(ctx->taskPool); iworker++)
+	simplePoolReset(&ctx->taskSlotPool[iworker]);
+    }
+
+  ctx->bankHashCount = 0;
+  if(++ctx->bankHashGen == 0)
+    {
+      /* Generation wrapped.  Start over with a clean table */
+      if(ctx->bankHash)
+	memset(ctx->bankHash, 0, (1 << ctx->bankHashBits) * sizeof(bankHashEntry));
+      ctx->bankHashGen = 1;
+    }
+}
+
+/* Address of the word at index (from the start of the event) of the event at
+   data, which may wrap to the start of the ring */
+static inline volatile unsigned int *
+simpleEventPtr(const simpleCtx *ctx, volatile unsigned int *data, int index)
+{
+  if(index < ctx->ringWrap)
+    return &data[index];
+
+  return &ctx->ringBase[index - ctx->ringWrap];
+}
+
+static inline unsigned int
+simpleEventWord(const simpleCtx *ctx, volatile unsigned int *data, int index)
+{
+  return *simpleEventPtr(ctx, data, index);
+}
+
+/* Address of the length words at index of the last event scanned, or NULL if
+   they straddle the end of the ring */
+static inline unsigned int *
+simpleEventAddr(const simpleCtx *ctx, int index, int length)
+{
+  if((index < ctx->ringWrap) && (index + length > ctx->ringWrap))
+    return NULL;
+
+  return (unsigned int *)simpleEventPtr(ctx, (volatile unsigned int *)ctx->dataAddr, index);
+}
+
+/* Return the bankData for rocID and bankID found in this event, otherwise NULL */
+static bankDataInfo *
+simpleFindBank(simpleCtx *ctx, int rocID, int bankID)
+{
+  unsigned int key, mask, ihash;
+
+  if(ctx->bankHash == NULL)
+    return NULL;
+
+  key = simpleBankKey(rocID, bankID);
+  mask = (1 << ctx->bankHashBits) - 1;
+
+  for(ihash = simpleBankHashSlot(ctx, key); ctx->bankHash[ihash].gen == ctx->bankHashGen;
+      ihash = (ihash + 1) & mask)
+    {
+      if(ctx->bankHash[ihash].key == key)
+	return ctx->bankHash[ihash].bank;
+    }
+
+  return NULL;
+}
+
+static int
+simpleBankHashInsert(simpleCtx *ctx, unsigned int key, bankDataInfo *bank)
+{
+  unsigned int mask, ihash;
+
+  /* Keep the load factor under 1/2 */
+  if((ctx->bankHash == NULL) || (2 * (ctx->bankHashCount + 1) > (1 << ctx->bankHashBits)))
+    {
+      bankHashEntry *old = ctx->bankHash;
+      unsigned int oldsize = old ? (1 << ctx->bankHashBits) : 0, iold;
+
+      ctx->bankHashBits = old ? (ctx->bankHashBits + 1) : SIMPLE_BANK_HASH_BITS;
+      ctx->bankHash = (bankHashEntry *) calloc(1 << ctx->bankHashBits, sizeof(bankHashEntry));
+      if(ctx->bankHash == NULL)
+	{
+	  ctx->bankHash = old;
+	  ctx->bankHashBits = old ? (ctx->bankHashBits - 1) : 0;
+	  return ERROR;
+	}
+
+      mask = (1 << ctx->bankHashBits) - 1;
+      for(iold = 0; iold < oldsize; iold++)
+	{
+	  if(old[iold].gen != ctx->bankHashGen)
+	    continue;
+
+	  for(ihash = simpleBankHashSlot(ctx, old[iold].key); ctx->bankHash[ihash].gen == ctx->bankHashGen;
+	      ihash = (ihash + 1) & mask);
+	  ctx->bankHash[ihash] = old[iold];
+	}
+      free(old);
+    }
+
+  mask = (1 << ctx->bankHashBits) - 1;
+  for(ihash = simpleBankHashSlot(ctx, key); ctx->bankHash[ihash].gen == ctx->bankHashGen;
+      ihash = (ihash + 1) & mask);
+
+  ctx->bankHash[ihash].key  = key;
+  ctx->bankHash[ihash].gen  = ctx->bankHashGen;
+  ctx->bankHash[ihash].bank = bank;
+  ctx->bankHashCount++;
+
+  return OK;
+}
+
+/* Return the bankData for rocID and bankID, allocating it if this is the first time
+   it's been found in the event */
+static bankDataInfo *
+simpleAddBank(simpleCtx *ctx, int rocID, int bankID)
+{
+  bankDataInfo *bank;
+
+  bank = simpleFindBank(ctx, rocID, bankID);
+  if(bank)
+    return bank;
+
+  bank = (bankDataInfo *) simplePoolAlloc(&ctx->bankPool);
+  if(bank == NULL)
+    return NULL;
+
+  memset(bank, 0, sizeof(bankDataInfo));
+  bank->rocID = rocID;
+  bank->bankID = bankID;
+
+  if(simpleBankHashInsert(ctx, simpleBankKey(rocID, bankID), bank) != OK)
+    return NULL;
+
+  return bank;
+}
+
+/* Return the slot data for the bank, allocating it if this is the first time
+   the slot has been found in the bank */
+static slotDataInfo *
+simpleBankSlot(simplePool *slotPool, bankDataInfo *bank, int slot)
+{
+  slotDataInfo *sd = bank->slot[slot];
+
+  if(sd == NULL)
+    {
+      sd = (slotDataInfo *) simplePoolAlloc(slotPool);
+      if(sd == NULL)
+	return NULL;
+
+      sd->blkIndex = 0;
+      sd->blkTrailerIndex = 0;
+      sd->nevents = 0;
+      sd->maxEvents = 0;
+      sd->evt = NULL;
+      bank->slot[slot] = sd;
+    }
+
+  return sd;
+}
+
+static int simpleScanTriggerBank(simpleCtx *ctx, volatile unsigned int *data, int nwords);
+static int simpleScanRocBank(simpleCtx *ctx, volatile unsigned int *data, int iword, int nwords);
+static int simpleScanEventEnd(simpleCtx *ctx, int iword, int nwords);
+static int simpleScanCodaEventData(simpleCtx *ctx, volatile unsigned int *data,
+				   int bufferWords);
+static int simpleScanBankData(simpleCtx *ctx, simplePool *slotPool,
+			      volatile unsigned int *data, int rocID, int bankNumber);
+
+#ifdef SIMPLE_STATS
+static inline unsigned long long
+simpleStatsNow()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* Stats of a bank.  Banks come in the same order in each event, so the
+   entry after the last one is tried first */
+static simpleBankStats *
+simpleStatsBank(simpleCtx *ctx, int rocID, int bankID)
+{
+  simpleBankStats *bs;
+  int i;
+
+  if((ctx->bankStatsNext < ctx->nBankStats) &&
+     (ctx->bankStats[ctx->bankStatsNext].rocID == rocID) &&
+     (ctx->bankStats[ctx->bankStatsNext].bankID == bankID))
+    i = ctx->bankStatsNext;
+  else
+    {
+      for(i = 0; i < ctx->nBankStats; i++)
+	if((ctx->bankStats[i].rocID == rocID) && (ctx->bankStats[i].bankID == bankID))
+	  break;
+    }
+
+  if(i == ctx->nBankStats)
+    {
+      if(ctx->nBankStats == ctx->bankStatsSize)
+	{
+	  int size = ctx->bankStatsSize ? 2 * ctx->bankStatsSize : 16;
+	  bs = (simpleBankStats *) realloc(ctx->bankStats, size * sizeof(simpleBankStats));
+	  if(bs == NULL)
+	    return NULL;
+	  ctx->bankStats = bs;
+	  ctx->bankStatsSize = size;
+	}
+      bs = &ctx->bankStats[ctx->nBankStats++];
+      memset(bs, 0, sizeof(simpleBankStats));
+      bs->rocID  = rocID;
+      bs->bankID = bankID;
+    }
+
+  ctx->bankStatsNext = i + 1;
+
+  return &ctx->bankStats[i];
+}
+
+/* Add what the last scan of a bank found to the stats */
+static void
+simpleStatsAddBank(simpleCtx *ctx, bankDataInfo *bank)
+{
+  simpleStats *st = &ctx->stat;
+  simpleBankStats *bs;
+
+  st->nbanks++;
+  st->nbankWords     += bank->bank.length;
+  st->nblockHeaders  += bank->count.nblockHeaders;
+  st->neventHeaders  += bank->count.neventHeaders;
+  st->nblockTrailers += bank->count.nblockTrailers;
+  st->nscalerWords   += bank->count.nscalerWords;
+  st->nerrors[SIMPLE_STATS_ERROR_BLOCK] += bank->count.nblockErrors;
+  if(bank->count.status == ERROR)
+    st->nerrors[SIMPLE_STATS_ERROR_BANK]++;
+  st->bankNsec += bank->count.nsec;
+
+  bs = simpleStatsBank(ctx, bank->rocID, bank->bankID);
+  if(bs == NULL)
+    return;
+
+  bs->nbanks++;
+  bs->nwords += bank->bank.length;
+  if(bank->count.status == ERROR)
+    bs->nerrors++;
+  bs->nsec += bank->count.nsec;
+}
+#endif
+
+/* Whether the print rate of the context allows one more error to be printed */
+static int
+simpleErrorPrintAllowed(simpleCtx *ctx)
+{
+  long now;
+  int suppressed;
+
+  if(ctx->errorPrintRate < 0)
+    return 1;
+  if(ctx->errorPrintRate == 0)
+    return 0;
+
+  now = (long) time(NULL);
+  if(__atomic_load_n(&ctx->errorPrintSecond, __ATOMIC_RELAXED) != now)
+    {
+      __atomic_store_n(&ctx->errorPrintSecond, now, __ATOMIC_RELAXED);
+      __atomic_store_n(&ctx->errorPrinted, 0, __ATOMIC_RELAXED);
+      suppressed = __atomic_exchange_n(&ctx->errorSuppressed, 0, __ATOMIC_RELAXED);
+      if(suppressed)
+	printf("simpleScan: %d more errors were not printed\n", suppressed);
+    }
+
+  if(__atomic_fetch_add(&ctx->errorPrinted, 1, __ATOMIC_RELAXED) < ctx->errorPrintRate)
+    return 1;
+
+  __atomic_fetch_add(&ctx->errorSuppressed, 1, __ATOMIC_RELAXED);
+  return 0;
+}
+
+/* Record an error found by the scan: count it, keep it, and print it if
+   the print rate allows.  Workers of a parallel scan may call it at once */
+static void
+simpleCtxError(simpleCtx *ctx, int code, int index, unsigned int word,
+	       int rocID, int bankID, int slot, int value, int expected)
+{
+  simpleError err;
+  unsigned long long pos;
+
+  err.code     = code;
+  err.index    = index;
+  err.word     = word;
+  err.rocID    = rocID;
+  err.bankID   = bankID;
+  err.slot     = slot;
+  err.value    = value;
+  err.expected = expected;
+  err.event    = ctx->nscans;
+
+  if((code > SIMPLE_ERROR_NONE) && (code < SIMPLE_ERROR_NCODES))
+    __atomic_fetch_add(&ctx->errorCount[code], 1, __ATOMIC_RELAXED);
+
+  pos = __atomic_fetch_add(&ctx->errorHead, 1, __ATOMIC_RELAXED);
+  ctx->error[pos % SIMPLE_MAX_ERRORS] = err;
+
+  if(simpleErrorPrintAllowed(ctx))
+    simplePrintError(&err);
+}
+
+/* simpleScanCodaEventData(), counted and timed if stats are on */
+static int
+simpleScanCodaEventStats(simpleCtx *ctx, volatile unsigned int *data, int bufferWords)
+{
+#ifdef SIMPLE_STATS
+  if(ctx->stats)
+    {
+      unsigned long long start = simpleStatsNow();
+      int rval = simpleScanCodaEventData(ctx, data, bufferWords);
+
+      ctx->stat.eventNsec += simpleStatsNow() - start;
+      ctx->stat.nevents++;
+      if(rval == OK)
+	ctx->stat.nwords += data[0] + 1;
+      else
+	ctx->stat.nerrors[SIMPLE_STATS_ERROR_EVENT]++;
+
+      return rval;
+    }
+#endif
+
+  return simpleScanCodaEventData(ctx, data, bufferWords);
+}
+
+/* Order banks by decreasing length */
+static int
+simpleBankLengthCompare(const void *a, const void *b)
+{
+  const bankDataInfo *ba = *(bankDataInfo * const *)a;
+  const bankDataInfo *bb = *(bankDataInfo * const *)b;
+
+  return bb->bank.length - ba->bank.length;
+}
+
+static void
+simpleScanBankTask(void *arg, int itask, int iworker)
+{
+  simpleCtx *ctx = (simpleCtx *) arg;
+  bankDataInfo *bank = ctx->taskBank[itask];
+
+  simpleScanBankData(ctx, &ctx->taskSlotPool[iworker], ctx->taskData,
+		     bank->rocID, bank->bankID);
+}
+
+/* Scan the banks found in the event with the task pool */
+static int
+simpleScanBanksParallel(simpleCtx *ctx, volatile unsigned int *data)
+{
+  int iroc, ibank, ntasks = 0;
+
+  for(iroc = 0; iroc < ctx->nRocs; iroc++)
+    ntasks += ctx->rocBank[ctx->rocList[iroc]].nbanks;
+
+  if(ntasks > ctx->taskBankSize)
+    {
+      bankDataInfo **taskBank;
+
+      taskBank = (bankDataInfo **) realloc(ctx->taskBank, ntasks * sizeof(bankDataInfo *));
+      if(taskBank == NULL)
+	return ERROR;
+      ctx->taskBank = taskBank;
+      ctx->taskBankSize = ntasks;
+    }
+
+  ntasks = 0;
+  for(iroc = 0; iroc < ctx->nRocs; iroc++)
+    {
+      rocBankInfo *roc = &ctx->rocBank[ctx->rocList[iroc]];
+
+      if(roc->length <= 0)
+	continue;
+
+      for(ibank = 0; ibank < roc->nbanks; ibank++)
+	{
+	  if(roc->dataBank[ibank]->bank.length > 0)
+	    ctx->taskBank[ntasks++] = roc->dataBank[ibank];
+	}
+    }
+
+  qsort(ctx->taskBank, ntasks, sizeof(bankDataInfo *), simpleBankLengthCompare);
+
+  ctx->taskData = data;
+
+  if(simpleTaskPoolRun(ctx->taskPool, simpleScanBankTask, ctx, ntasks) != OK)
+    return ERROR;
+
+#ifdef SIMPLE_STATS
+  /* The workers left their counts in the banks */
+  if(ctx->stats)
+    {
+      int itask;
+
+      for(itask = 0; itask < ntasks; itask++)
+	simpleStatsAddBank(ctx, ctx->taskBank[itask]);
+    }
+#endif
+
+  return OK;
+}
+
+/* Scan the data banks of a ROC bank */
+static void
+simpleScanRocData(simpleCtx *ctx, volatile unsigned int *data, int rocID)
+{
+  rocBankInfo *roc = &ctx->rocBank[rocID];
+  int ibank;
+
+  /* Check if the rocBank exists */
+  if((roc->length > 0))
+    {
+      for(ibank=0; ibank<roc->nbanks; ibank++)
+	{
+	  /* Check if the dataBank for that ROC exists */
+	  if((roc->dataBank[ibank]->bank.length > 0))
+	    {
+	      /* Scan it */
+	      simpleCtxScanBank(ctx, data, rocID, roc->dataBank[ibank]->bankID);
+	    }
+	}
+    }
+}
+
+/* Index the event at data, in a buffer of nwords words, after the index
+   of the last one was reset */
+static int
+simpleScanEvent(simpleCtx *ctx, volatile unsigned int *data, int nwords)
+{
+  int iroc = 0;
+
+  ctx->dataAddr = (unsigned long) data;
+
+  /* Scan over to get Bank indices.. */
+  if(ctx->debugMask & SIMPLE_SHOW_UNBLOCK)
+    {
+      printf("%s: Scan CODA Event for Banks\n",__FUNCTION__);
+    }
+  if(simpleScanCodaEventStats(ctx, data, nwords) != OK)
+    return ERROR;
+
+  if(ctx->debugMask & SIMPLE_SHOW_UNBLOCK)
+    {
+      printf("%s: Start Banks for Events\n",__FUNCTION__);
+    }
+
+  /* Data banks are indexed by the access routines */
+  if(ctx->lazy)
+    return OK;
+
+  /* Scan over to get event indices */
+  if(ctx->taskPool)
+    return simpleScanBanksParallel(ctx, data);
+
+  for(iroc=0; iroc<ctx->nRocs; iroc++)
+    simpleScanRocData(ctx, data, ctx->rocList[iroc]);
+
+  return OK;
+}
+
+int
+simpleCtxScan(simpleCtx *ctx, volatile unsigned int *data, int nwords)
+{
+  simpleResetIndex(ctx);
+
+  return simpleScanEvent(ctx, data, nwords);
+}
+
+/**
+ * @ingroup Unblock
+ * @brief Scan a CODA event in place in a ring buffer, where it may wrap
+ *    around the end of the ring to its start.  The index is the same as
+ *    from simpleCtxScan() of the event copied out of the ring.
+ *
+ *    Data accessed through a pointer (simpleCtxGetRocBankData(),
+ *    simpleCtxGetSlotEventData(), the trigger bank segments) is an ERROR
+ *    if it wraps.  Get it in its two parts with simpleCtxGetRocBankSpan()
+ *    and simpleCtxGetSlotEventSpan().  Banks byte swapped into the swap
+ *    buffer never wrap.
+ *
+ * @param ctx    Scan context
+ * @param base   First word of the ring
+ * @param size   Size of the ring, in words
+ * @param start  Index in the ring of the event's length word
+ *
+ * @return OK if successful, otherwise ERROR
+ */
+int
+simpleCtxScanRing(simpleCtx *ctx, volatile unsigned int *base, int size, int start)
+{
+  if((base == NULL) || (size < 2) || (start < 0) || (start >= size))
+    {
+      printf("%s: ERROR: Invalid ring (base %p, size %d, start %d)\n",
+	     __func__, (void *)base, size, start);
+      return ERROR;
+    }
+
+  simpleResetIndex(ctx);
+
+  /* Event words from here on are at the start of the ring */
+  ctx->ringBase = (unsigned int *)base;
+  ctx->ringWrap = size - start;
+
+  return simpleScanEvent(ctx, &base[start], size);
+}
+
+/**
+ * @ingroup Unblock
+ * @brief Start the scan of a CODA event that is still arriving in data,
+ *    from a socket, DMA or read() loop.  Feed it with simpleCtxStreamFeed()
+ *    as the words come in.
+ *
+ * @param ctx          Scan context
+ * @param data         Buffer the event is received into, from its length word
+ * @param bufferWords  Size of the buffer, in words
+ *
+ * @return OK if successful, otherwise ERROR
+ */
+int
+simpleCtxStreamStart(simpleCtx *ctx, volatile unsigned int *data, int bufferWords)
+{
+  if(data == NULL)
+    {
+      printf("%s: ERROR: NULL buffer\n", __func__);
+      return ERROR;
+    }
+
+  simpleResetIndex(ctx);
+
+  ctx->dataAddr = (unsigned long) data;
+  ctx->streamState = SIMPLE_STREAM_STATE_HEADER;
+  ctx->streamBufferWords = bufferWords;
+  ctx->streamNext = 0;
+  ctx->nscans++;
+
+  return OK;
+}
+
+/**
+ * @ingroup Unblock
+ * @brief Scan what has arrived of the event started by simpleCtxStreamStart().
+ *    The trigger bank is indexed once all its words are in, then each ROC
+ *    bank (and its data banks, unless lazy) once all of its words are.
+ *    ROC banks done are the first *nrocs of simpleCtxGetRocList(), in the
+ *    order they arrived, and may be accessed while the rest of the event
+ *    comes in.  The data banks are scanned by the calling thread, also with
+ *    simpleCtxConfigParallelBanks().
+ *
+ * @param ctx        Scan context
+ * @param nwords     Words of the event in the buffer so far, from its length word
+ * @param *nrocs     Where to store the number of ROC banks done.  May be NULL.
+ *
+ * @return OK once the whole event is scanned, SIMPLE_STREAM_MORE if it needs
+ *         more words, otherwise ERROR
+ */
+int
+simpleCtxStreamFeed(simpleCtx *ctx, int nwords, int *nrocs)
+{
+  volatile unsigned int *data = (volatile unsigned int *)ctx->dataAddr;
+  int eventWords, next, nrocs0, all;
+
+  switch(ctx->streamState)
+    {
+    case SIMPLE_STREAM_STATE_IDLE:
+      printf("%s: ERROR: No event started\n", __func__);
+      return ERROR;
+    case SIMPLE_STREAM_STATE_ERROR:
+      return ERROR;
+    default:
+      break;
+    }
+
+  if(nwords > ctx->streamBufferWords)
+    nwords = ctx->streamBufferWords;
+
+  /* First word should be the length of the CODA event, and it has to fit the buffer */
+  if(ctx->streamState == SIMPLE_STREAM_STATE_HEADER)
+    {
+      if(nwords < 1)
+	goto more;
+
+      eventWords = data[0];
+      if((ctx->streamBufferWords < 2) || (eventWords < 1) ||
+	 (eventWords > ctx->streamBufferWords - 1))
+	{
+	  simpleCtxError(ctx, SIMPLE_ERROR_EVENT_LENGTH, 0, data[0], -1, -1, -1,
+			 eventWords, ctx->streamBufferWords - 1);
+	  goto fail;
+	}
+      ctx->streamState = SIMPLE_STREAM_STATE_TRIGGER;
+    }
+
+  eventWords = data[0];
+  all = (nwords >= eventWords + 1);
+
+  /* Trigger bank, once all of it is in */
+  if(ctx->streamState == SIMPLE_STREAM_STATE_TRIGGER)
+    {
+      if(!all && ((nwords < 4) || (nwords - 3 < data[2])))
+	goto more;
+
+      next = simpleScanTriggerBank(ctx, data, eventWords);
+      if(next == ERROR)
+	goto fail;
+      ctx->streamNext = next;
+      ctx->streamState = SIMPLE_STREAM_STATE_ROCS;
+    }
+
+  /* Each ROC bank, once all of it is in */
+  while(ctx->streamState == SIMPLE_STREAM_STATE_ROCS)
+    {
+      next = ctx->streamNext;
+      if(next >= eventWords)
+	{
+	  if(simpleScanEventEnd(ctx, next, eventWords) != OK)
+	    goto fail;
+	  ctx->streamState = SIMPLE_STREAM_STATE_DONE;
+#ifdef SIMPLE_STATS
+	  if(ctx->stats)
+	    {
+	      ctx->stat.nevents++;
+	      ctx->stat.nwords += eventWords + 1;
+	    }
+#endif
+	  break;
+	}
+
+      if(!all && ((nwords < next + 2) || (nwords - next - 1 < data[next])))
+	break;
+
+      nrocs0 = ctx->nRocs;
+      ctx->streamNext = simpleScanRocBank(ctx, data, next, eventWords);
+      if(ctx->streamNext == ERROR)
+	goto fail;
+
+      /* Not a ROC bank found again, and skipped */
+      if(!ctx->lazy && (ctx->nRocs > nrocs0))
+	simpleScanRocData(ctx, data, ctx->rocList[ctx->nRocs - 1]);
+    }
+
+ more:
+  if(nrocs)
+    *nrocs = ctx->nRocs;
+
+  return (ctx->streamState == SIMPLE_STREAM_STATE_DONE) ? OK : SIMPLE_STREAM_MORE;
+
+ fail:
+  ctx->streamState = SIMPLE_STREAM_STATE_ERROR;
+#ifdef SIMPLE_STATS
+  if(ctx->stats)
+    {
+      ctx->stat.nevents++;
+      ctx->stat.nerrors[SIMPLE_STATS_ERROR_EVENT]++;
+    }
+#endif
+  if(nrocs)
+    *nrocs = ctx->nRocs;
+
+  return ERROR;
+}
+
+/* Count a bank stepped over by ignoreUndefinedBanks.  Banks come in the
+   same order in each event, so the entry after the last one is tried first */
+static void
+simpleCountSkippedBank(simpleCtx *ctx, int rocID, int bankID, int nwords)
+{
+  simpleSkipCount *sc = NULL;
+  int i;
+
+  if((ctx->skipCountNext < ctx->nSkipCount) &&
+     (ctx->skipCount[ctx->skipCountNext].rocID == rocID) &&
+     (ctx->skipCount[ctx->skipCountNext].bankID == bankID))
+    i = ctx->skipCountNext;
+  else
+    {
+      for(i = 0; i < ctx->nSkipCount; i++)
+	if((ctx->skipCount[i].rocID == rocID) && (ctx->skipCount[i].bankID == bankID))
+	  break;
+    }
+
+  if(i == ctx->nSkipCount)
+    {
+      if(ctx->nSkipCount == ctx->skipCountSize)
+	{
+	  int size = ctx->skipCountSize ? 2 * ctx->skipCountSize : 16;
+	  sc = (simpleSkipCount *) realloc(ctx->skipCount, size * sizeof(simpleSkipCount));
+	  if(sc == NULL)
+	    return;
+	  ctx->skipCount = sc;
+	  ctx->skipCountSize = size;
+	}
+      sc = &ctx->skipCount[ctx->nSkipCount++];
+      sc->rocID  = rocID;
+      sc->bankID = bankID;
+      sc->nbanks = 0;
+      sc->nwords = 0;
+    }
+
+  sc = &ctx->skipCount[i];
+  sc->nbanks++;
+  sc->nwords += nwords;
+  ctx->skipCountNext = i + 1;
+}
+
+/* Add a data bank of the ROC to the index.  index and length are of the
+   data inside the bank */
+static bankDataInfo *
+simpleIndexDataBank(simpleCtx *ctx, volatile unsigned int *data, int rocID,
+		    int userBankIndex, bankHeader_t header, int index, int length)
+{
+  bankDataInfo *dataBank;
+  int bankID = header.bf.tag;
+
+  dataBank = simpleFindBank(ctx, rocID, bankID);
+  if(dataBank == NULL)
+    {
+      if(ctx->rocBank[rocID].nbanks >= SIMPLE_MAX_BANKS)
+	{
+	  simpleCtxError(ctx, SIMPLE_ERROR_TOO_MANY_BANKS, index - 1, header.raw,
+			 rocID, bankID, -1, SIMPLE_MAX_BANKS + 1, SIMPLE_MAX_BANKS);
+	  return NULL;
+	}
+
+      dataBank = simpleAddBank(ctx, rocID, bankID);
+      if(dataBank == NULL)
+	{
+	  simpleCtxError(ctx, SIMPLE_ERROR_ALLOC, index - 1, header.raw,
+			 rocID, bankID, -1, 0, 0);
+	  return NULL;
+	}
+      ctx->rocBank[rocID].dataBank[ctx->rocBank[rocID].nbanks++] = dataBank;
+    }
+
+  /* We save the bank header and length in the struct,
+     so .index and .length here refer to the data inside */
+  dataBank->bank.length = length;
+  dataBank->bank.index  = index;
+  dataBank->bank.header.raw = header.raw;
+  dataBank->bankBase = (unsigned int *)simpleEventPtr(ctx, data, index);
+  dataBank->wrap = length;
+  dataBank->wrapBase = NULL;
+  if((index < ctx->ringWrap) && (index + length > ctx->ringWrap))
+    {
+      dataBank->wrap = ctx->ringWrap - index;
+      dataBank->wrapBase = ctx->ringBase;
+    }
+
+  dataBank->config = (userBankIndex >= 0) ?
+    &ctx->config->uBank[userBankIndex] : NULL;
+
+  /* Reserve room for the banks swapped into the swap buffer */
+  dataBank->swapMode = SIMPLE_SWAP_NONE;
+  if(dataBank->config && dataBank->config->endian)
+    {
+      dataBank->swapMode = dataBank->config->swapMode;
+
+      if(dataBank->swapMode == SIMPLE_SWAP_BUFFER)
+	{
+	  if((length > 0) &&
+	     (ctx->swapBufferUsed + length <= ctx->swapBufferSize))
+	    {
+	      dataBank->bankBase = &ctx->swapBuffer[ctx->swapBufferUsed];
+	      ctx->swapBufferUsed += length;
+	    }
+	  else
+	    dataBank->swapMode = SIMPLE_SWAP_NONE;
+	}
+    }
+
+  return dataBank;
+}
+
+/* Configured module header of the flat ROC bank that word starts, otherwise -1 */
+static inline int
+simpleMatchModuleHeader(const simpleConfig *config, const int *headerBank, int nheaders,
+			unsigned int word)
+{
+  int ih;
+
+  for(ih = 0; ih < nheaders; ih++)
+    {
+      const simpleBankConfig *ub = &config->uBank[headerBank[ih]];
+      unsigned int w = ub->endian ? bswap_32(word) : word;
+
+      if((w & ub->header_mask) == ub->module_header)
+	return ih;
+    }
+
+  return -1;
+}
+
+/* Close the bank of a flat ROC bank that started at start, and ends before end */
+static int
+simpleFlatRocBank(simpleCtx *ctx, volatile unsigned int *data, int rocID,
+		  int userBankIndex, int start, int end)
+{
+  bankHeader_t header;
+  bankDataInfo *dataBank;
+  const simpleBankConfig *ub = &ctx->config->uBank[userBankIndex];
+
+  if(simpleFindBank(ctx, rocID, ub->header.bf.tag) != NULL)
+    {
+      /* Skipped */
+      simpleCtxError(ctx, SIMPLE_ERROR_DUPLICATE_BANK, start,
+		     simpleEventWord(ctx, data, start), rocID, ub->header.bf.tag, -1, 0, 0);
+      return OK;
+    }
+
+  header.raw = 0;
+  header.bf.tag  = ub->header.bf.tag;
+  header.bf.type = EVIO_UINT32;
+  header.bf.num  = ctx->rocBank[rocID].header.bf.num;
+
+  dataBank = simpleIndexDataBank(ctx, data, rocID, userBankIndex, header, start, end - start);
+  if(dataBank == NULL)
+    return ERROR;
+
+  SIMPLE_TRACE_WORD(ctx, SIMPLE_TRACE_FLAT_BANK, start, simpleEventWord(ctx, data, start),
+		    dataBank->bank.length);
+
+  return OK;
+}
+
+/**
+ * @ingroup Unblock
+ * @brief Split a ROC bank of uint32s into data banks.
+ *
+ *    A data bank starts at a word matching the module_header (under
+ *    header_mask) of a bank configured for this ROC, and runs up to the
+ *    module header of another bank, or the end of the ROC bank.  Words
+ *    before the first module header are not indexed.
+ *
+ *    If every module header needs a type defining word (bit 31 set in
+ *    both), only the type defining words are tested, found with the
+ *    same kernel as the bank scan.
+ *
+ * @param ctx     Scan context
+ * @param data    Memory address of the CODA event
+ * @param rocID   ROC bank to split
+ *
+ * @return OK if successful, otherwise ERROR
+ */
+static int
+simpleScanFlatRoc(simpleCtx *ctx, volatile unsigned int *data, int rocID)
+{
+  const simpleConfig *config = ctx->config;
+  const simpleKernel *kernel = simpleKernelGet();
+  int headerBank[SIMPLE_MAX_BANKS];
+  int nheaders = 0, ibank, iword, ih, current = -1, start = 0;
+  int first = ctx->rocBank[rocID].index;
+  int end = first + ctx->rocBank[rocID].length;
+  int defining = 1, endian = -1;
+
+  for(ibank = 0; ibank < config->nubanks; ibank++)
+    {
+      const simpleBankConfig *ub = &config->uBank[ibank];
+
+      if((ub->rocID != rocID) ||
+	 ((ub->module_header == 0) && (ub->header_mask == 0xFFFFFFFF)))
+	continue;
+
+      headerBank[nheaders++] = ibank;
+
+      if(((ub->module_header & ub->header_mask & 0x80000000) == 0) ||
+	 ((endian >= 0) && (ub->endian != endian)))
+	defining = 0;
+      endian = ub->endian;
+    }
+
+  if(nheaders == 0)
+    {
+      if(ctx->debugMask & SIMPLE_SHOW_BANK_NOT_FOUND)
+	printf("%s: rocID = %d: No module headers configured\n", __func__, rocID);
+      return OK;
+    }
+
+  if(defining)
+    {
+      int blockStart, nblock;
+      const unsigned int *block;
+      unsigned long long defMask;
+
+      for(blockStart = first; blockStart < end; blockStart += nblock)
+	{
+	  nblock = end - blockStart;
+	  if(nblock > SIMPLE_KERNEL_WORDS)
+	    nblock = SIMPLE_KERNEL_WORDS;
+	  /* Not across the end of a ring */
+	  if((blockStart < ctx->ringWrap) && (nblock > ctx->ringWrap - blockStart))
+	    nblock = ctx->ringWrap - blockStart;
+
+	  block = (const unsigned int *)simpleEventPtr(ctx, data, blockStart);
+	  if(endian)
+	    defMask = (*kernel->definingMaskSwap)(block, nblock);
+	  else
+	    defMask = (*kernel->definingMask)(block, nblock);
+
+	  while(defMask)
+	    {
+	      iword = blockStart + __builtin_ctzll(defMask);
+	      defMask &= defMask - 1;
+
+	      ih = simpleMatchModuleHeader(config, headerBank, nheaders,
+					   simpleEventWord(ctx, data, iword));
+	      if((ih < 0) || (ih == current))
+		continue;
+
+	      if((current >= 0) &&
+		 (simpleFlatRocBank(ctx, data, rocID, headerBank[current], start, iword) != OK))
+		return ERROR;
+	      current = ih;
+	      start = iword;
+	    }
+	}
+    }
+  else
+    {
+      for(iword = first; iword < end; iword++)
+	{
+	  ih = simpleMatchModuleHeader(config, headerBank, nheaders,
+				       simpleEventWord(ctx, data, iword));
+	  if((ih < 0) || (ih == current))
+	    continue;
+
+	  if((current >= 0) &&
+	     (simpleFlatRocBank(ctx, data, rocID, headerBank[current], start, iword) != OK))
+	    return ERROR;
+	  current = ih;
+	  start = iword;
+	}
+    }
+
+  if(current >= 0)
+    return simpleFlatRocBank(ctx, data, rocID, headerBank[current], start, end);
+
+  return OK;
+}
+
+/**
+ * @ingroup Unblock
+ * @brief Pass over the CODA event to determine Bank types and indicies
+ *
+ * @param ctx        Scan context
+ * @param data Memory address of the data
+ *
+ * @return OK if successful, otherwise ERROR
+ */
+int
+simpleCtxScanCodaEvent(simpleCtx *ctx, volatile unsigned int *data)
+{
+  return simpleScanCodaEventStats(ctx, data, data[0] + 1);
+}
+
+/* Check the CODA event header of an event of nwords + 1 words, and index its
+   trigger bank.  Return the index after it if successful, otherwise ERROR */
+static int
+simpleScanTriggerBank(simpleCtx *ctx, volatile unsigned int *data, int nwords)
+{
+  int iword = 1, trigEnd;
+  bankHeader_t bh;
+
+  /* Next word should be the CODA Event header */
+  bh.raw = simpleEventWord(ctx, data, iword++);
+  SIMPLE_TRACE_WORD(ctx, SIMPLE_TRACE_EVENT, 1, bh.raw, nwords);
+
+  if(bh.bf.type == EVIO_BANK)
+    {
+      /* Hopefully this is the start of the trigger bank */
+      if(nwords < 3)
+	{
+	  simpleCtxError(ctx, SIMPLE_ERROR_TRIGGER_LENGTH, 1, bh.raw, -1, -1, -1,
+			 nwords, 3);
+	  return ERROR;
+	}
+      ctx->trigBank.length = simpleEventWord(ctx, data, iword++);
+      ctx->trigBank.header.raw = simpleEventWord(ctx, data, iword++);
+      ctx->trigBank.index = iword;
+
+      trigEnd = ctx->trigBank.index + ctx->trigBank.length - 1;
+      if((ctx->trigBank.length < 1) || (trigEnd > nwords + 1))
+	{
+	  simpleCtxError(ctx, SIMPLE_ERROR_TRIGGER_LENGTH, ctx->trigBank.index - 1,
+			 ctx->trigBank.header.raw, -1, -1, -1,
+			 ctx->trigBank.length, nwords + 2 - ctx->trigBank.index);
+	  return ERROR;
+	}
+
+      if(ctx->trigBank.header.bf.type == EVIO_SEGMENT)
+	{
+	  SIMPLE_TRACE_WORD(ctx, SIMPLE_TRACE_TRIGGER_BANK, ctx->trigBank.index - 1,
+			    ctx->trigBank.header.raw, ctx->trigBank.length);
+	}
+      else
+	{
+	  simpleCtxError(ctx, SIMPLE_ERROR_BANK_TYPE, ctx->trigBank.index - 1,
+			 ctx->trigBank.header.raw, -1, -1, -1,
+			 ctx->trigBank.header.bf.type, EVIO_SEGMENT);
+	  return ERROR;
+	}
+
+      /* init number of rocs */
+      ctx->trigBank.nrocs = 0;
+      /* Index each trigger segment */
+      while(iword < trigEnd)
+	{
+	  segmentHeader_t sh;
+	  sh.raw = simpleEventWord(ctx, data, iword++);
+
+	  if(iword + sh.bf.num > trigEnd)
+	    {
+	      simpleCtxError(ctx, SIMPLE_ERROR_SEGMENT_LENGTH, iword - 1, sh.raw, -1, -1, -1,
+			     sh.bf.num, trigEnd - iword);
+	      return ERROR;
+	    }
+
+	  SIMPLE_TRACE_WORD(ctx, SIMPLE_TRACE_SEGMENT, iword - 1, sh.raw, 0);
+
+	  switch(sh.bf.type)
+	    {
+	    case EVIO_ULONG64:	  /* Event number ( + timestamp) segment */
+	      {
+		ctx->trigBank.segTime.index = iword;
+		ctx->trigBank.segTime.header.raw = sh.raw;
+		break;
+	      }
+	    case EVIO_USHORT16:	  /* Event type segment */
+	      {
+		ctx->trigBank.segEvType.index = iword;
+		ctx->trigBank.segEvType.header.raw = sh.raw;
+		break;
+	      }
+	    case EVIO_UINT32:	  /* ROC segment */
+	      {
+		if(sh.bf.tag >= SIMPLE_MAX_ROCS)
+		  {
+		    simpleCtxError(ctx, SIMPLE_ERROR_ROC_ID, iword - 1, sh.raw, -1, -1, -1,
+				   sh.bf.tag, SIMPLE_MAX_ROCS - 1);
+		    return ERROR;
+		  }
+		/* A ROC found again keeps its first segment */
+		if(ctx->trigBank.segRoc[sh.bf.tag].header.raw != 0)
+		  break;
+		if(ctx->trigBank.nrocs >= SIMPLE_MAX_ROCS)
+		  {
+		    simpleCtxError(ctx, SIMPLE_ERROR_TRIGGER_NROCS, iword - 1, sh.raw, -1, -1, -1,
+				   ctx->trigBank.nrocs + 1, SIMPLE_MAX_ROCS);
+		    return ERROR;
+		  }
+		ctx->trigRocList[ctx->trigBank.nrocs] = sh.bf.tag;
+		ctx->trigBank.segRoc[sh.bf.tag].index = iword;
+		ctx->trigBank.segRoc[sh.bf.tag].header.raw = sh.raw;
+		ctx->trigBank.nrocs++;
+		break;
+	      }
+
+	    default:
+	      simpleCtxError(ctx, SIMPLE_ERROR_SEGMENT_TYPE, iword - 1, sh.raw, -1, -1, -1,
+			     sh.bf.type, EVIO_UINT32);
+	      return ERROR;
+	    }
+
+	  /* Move past this segment */
+	  iword += sh.bf.num;
+	}
+
+      if((ctx->validate >= SIMPLE_VALIDATE_FAST) &&
+	 (ctx->trigBank.nrocs != ctx->trigBank.header.bf.num))
+	{
+	  simpleCtxError(ctx, SIMPLE_ERROR_TRIGGER_NROCS, ctx->trigBank.index - 1,
+			 ctx->trigBank.header.raw, -1, -1, -1,
+			 ctx->trigBank.nrocs, ctx->trigBank.header.bf.num);
+	  return ERROR;
+	}
+    }
+  else
+    {
+      simpleCtxError(ctx, SIMPLE_ERROR_BANK_TYPE, 1, bh.raw, -1, -1, -1,
+		     bh.bf.type, EVIO_BANK);
+      return ERROR;
+    }
+
+  return iword;
+}
+
+/* Scan the ROC bank at iword (its length word) of an event of nwords + 1 words:
+   index its data banks.  Return the index after it if successful, otherwise ERROR */
+static int
+simpleScanRocBank(simpleCtx *ctx, volatile unsigned int *data, int iword, int nwords)
+{
+  bankHeader_t rocBankHeader;
+  int rocBankLength = 0, rocID = 0, rocEnd, bank_type;
+
+  /* Index the ROC bank header */
+  rocBankLength = simpleEventWord(ctx, data, iword++) - 1;
+  rocBankHeader.raw = simpleEventWord(ctx, data, iword++);
+  rocEnd = iword + rocBankLength;
+
+  if((rocBankLength < 0) || (rocEnd > nwords + 1))
+    {
+      simpleCtxError(ctx, SIMPLE_ERROR_ROC_LENGTH, iword - 1, rocBankHeader.raw,
+		     rocBankHeader.bf.tag & 0x0FFF, -1, -1,
+		     rocBankLength + 1, nwords + 2 - iword);
+      return ERROR;
+    }
+
+  rocID = rocBankHeader.bf.tag & 0x0FFF;
+
+  if(rocID >= SIMPLE_MAX_ROCS)
+    {
+      simpleCtxError(ctx, SIMPLE_ERROR_ROC_ID, iword - 1, rocBankHeader.raw, -1, -1, -1,
+		     rocID, SIMPLE_MAX_ROCS - 1);
+      return ERROR;
+    }
+
+  /* Index each ROC once.  Its banks are already in the bank lookup */
+  if(ctx->rocBank[rocID].found || (ctx->nRocs >= SIMPLE_MAX_ROCS))
+    {
+      simpleCtxError(ctx, SIMPLE_ERROR_DUPLICATE_ROC, iword - 1, rocBankHeader.raw,
+		     rocID, -1, -1, ctx->nRocs, SIMPLE_MAX_ROCS);
+      return rocEnd;
+    }
+  ctx->rocBank[rocID].found = 1;
+  ctx->rocList[ctx->nRocs++] = rocID;
+
+  ctx->rocBank[rocID].header.raw = rocBankHeader.raw;
+  ctx->rocBank[rocID].index = iword;
+  ctx->rocBank[rocID].length = rocBankLength;
+
+  SIMPLE_TRACE_WORD(ctx, SIMPLE_TRACE_ROC_BANK, ctx->rocBank[rocID].index - 1,
+		    ctx->rocBank[rocID].header.raw, ctx->rocBank[rocID].length);
+
+  switch(ctx->rocBank[rocID].header.bf.type)
+    {
+    case EVIO_BANK: /* Roc Bank is a Bank of Banks */
+      {
+	ctx->rocBank[rocID].nbanks = 0;
+
+	/* Inside the ROC bank.
+	   Look for data banks and determine their lengths and indices */
+	while(iword < rocEnd - 1)
+	  {
+	    bankHeader_t dataBankHeader;
+	    int dataBankLength = 0, dataBankID = 0, dataBankIndex = 0;
+	    int userBankIndex;
+	    bankDataInfo *dataBank;
+
+	    dataBankLength = simpleEventWord(ctx, data, iword++) - 1;
+	    dataBankHeader.raw = simpleEventWord(ctx, data, iword++);
+	    dataBankIndex  = iword;
+	    dataBankID = dataBankHeader.bf.tag;
+
+	    if((dataBankLength < 0) || (dataBankIndex + dataBankLength > rocEnd))
+	      {
+		simpleCtxError(ctx, SIMPLE_ERROR_BANK_LENGTH, dataBankIndex - 1,
+			       dataBankHeader.raw, rocID, dataBankID, -1,
+			       dataBankLength + 1, rocEnd - dataBankIndex + 1);
+		return ERROR;
+	      }
+
+	    userBankIndex = simpleFindConfigBankIndex(ctx->config, rocID, dataBankID);
+
+	    /* Step over banks that were not configured, without indexing them */
+	    if((userBankIndex < 0) && ctx->config->ignoreUndefinedBanks)
+	      {
+		SIMPLE_TRACE_WORD(ctx, SIMPLE_TRACE_IGNORED_BANK, dataBankIndex - 1,
+				  dataBankHeader.raw, dataBankLength);
+
+		simpleCountSkippedBank(ctx, rocID, dataBankID, dataBankLength);
+
+		/* Jump to next bank */
+		iword += dataBankLength;
+		continue;
+	      }
+
+	    dataBank = simpleIndexDataBank(ctx, data, rocID, userBankIndex,
+					   dataBankHeader, dataBankIndex, dataBankLength);
+	    if(dataBank == NULL)
+	      return ERROR;
+
+	    SIMPLE_TRACE_WORD(ctx, SIMPLE_TRACE_DATA_BANK, dataBankIndex - 1,
+			      dataBankHeader.raw, dataBank->bank.length);
+
+	    /* Jump to next bank */
+	    iword += dataBank->bank.length;
+	  }
+
+	if((iword != rocEnd) && (ctx->validate >= SIMPLE_VALIDATE_FAST))
+	  {
+	    simpleCtxError(ctx, SIMPLE_ERROR_ROC_END, ctx->rocBank[rocID].index - 1,
+			   ctx->rocBank[rocID].header.raw, rocID, -1, -1, iword, rocEnd);
+	    return ERROR;
+	  }
+	iword = rocEnd;
+	break;
+      }
+
+    case EVIO_UINT32:  /* Roc Bank is a Bank of uint32s */
+      {
+	/* Split it into banks at the module headers configured with
+	   simpleConfigBankHeader() */
+	ctx->rocBank[rocID].nbanks = 0;
+
+	if(simpleScanFlatRoc(ctx, data, rocID) != OK)
+	  return ERROR;
+
+	iword = rocEnd;
+	break;
+      }
+
+    default:
+      bank_type = ctx->rocBank[rocID].header.bf.type;
+      simpleCtxError(ctx, SIMPLE_ERROR_BANK_TYPE, ctx->rocBank[rocID].index - 1,
+		     ctx->rocBank[rocID].header.raw, rocID, -1, -1, bank_type, EVIO_BANK);
+      return ERROR;
+    }
+
+  return iword;
+}
+
+/* The event must end where the last ROC bank does */
+static int
+simpleScanEventEnd(simpleCtx *ctx, int iword, int nwords)
+{
+  if((iword != nwords + 1) && (ctx->validate >= SIMPLE_VALIDATE_FAST))
+    {
+      simpleCtxError(ctx, SIMPLE_ERROR_EVENT_END, -1, 0, -1, -1, -1, iword, nwords + 1);
+      return ERROR;
+    }
+
+  return OK;
+}
+
+/* simpleCtxScanCodaEvent(), of an event in a buffer of bufferWords words */
+static int
+simpleScanCodaEventData(simpleCtx *ctx, volatile unsigned int *data, int bufferWords)
+{
+  int iword=0, nwords=0;
+
+  ctx->nscans++;
+
+  /* First word should be the length of the CODA event */
+  nwords = data[iword++];
+
+  /* Everything below stays inside the event, so that has to fit the buffer */
+  if((bufferWords < 2) || (nwords < 1) || (nwords > bufferWords - 1))
+    {
+      simpleCtxError(ctx, SIMPLE_ERROR_EVENT_LENGTH, 0, data[0], -1, -1, -1,
+		     nwords, bufferWords - 1);
+      return ERROR;
+    }
+
+  iword = simpleScanTriggerBank(ctx, data, nwords);
+  if(iword == ERROR)
+    return ERROR;
+
+  /* ROC Banks start here */
+  while(iword<nwords)
+    {
+      iword = simpleScanRocBank(ctx, data, iword, nwords);
+      if(iword == ERROR)
+	return ERROR;
+    }
+
+  return simpleScanEventEnd(ctx, iword, nwords);
+}
+
+/**
+ * @ingroup Unblock
+ * @brief Scan through a ROC's bank to determine Event header indicies
+ *
+ *    The bank is indexed by the firstPassRoutine given to
+ *    simpleConfigBank(), or simpleScanJLab() if there was none.
+ *
+ * @param ctx        Scan context
+ * @param data       Memory address of the data
+ * @param rocID      Which ROC bank to find the Bank
+ * @param bankNumber Which Bank to index.
+ *
+ * @return OK if successful, otherwise ERROR
+ */
+
+int
+simpleCtxScanBank(simpleCtx *ctx, volatile unsigned int *data, int rocID, int bankNumber)
+{
+  return simpleScanBankData(ctx, &ctx->slotPool, data, rocID, bankNumber);
+}
+
+/* simpleCtxScanBank(), with slot data allocated from slotPool */
+static int
+simpleScanBankData(simpleCtx *ctx, simplePool *slotPool,
+		   volatile unsigned int *data, int rocID, int bankNumber)
+{
+  int endian = 0, rval = 0;
+  const simpleKernel *kernel = simpleKernelGet();
+  bankDataInfo *bank;
+  simpleBankScan scan;
+  simpleScanRoutine scanRoutine;
+#ifdef SIMPLE_STATS
+  unsigned long long start = 0;
+#endif
+
+  /* Check if this rocID and bankNumber combo were found in simpleScanCodaEvent */
+  bank = NULL;
+  if((rocID >= 0) && (rocID < SIMPLE_MAX_ROCS) &&
+     ((ctx->rocBank[rocID].header.bf.tag & 0x0FFF) == rocID))
+    bank = simpleFindBank(ctx, rocID, bankNumber);
+
+  if(bank == NULL)
+    {
+      if(ctx->debugMask & SIMPLE_SHOW_BANK_NOT_FOUND)
+	{
+	  printf("%s: rocID = 0x%x, bankNumber = 0x%x NOT found\n",
+		 __func__, rocID, bankNumber);
+	}
+      return -1;
+    }
+
+  bank->indexed = 1;
+  bank->evtView = NULL;
+  memset(&bank->count, 0, sizeof(simpleScanCount));
+
+#ifdef SIMPLE_STATS
+  if(ctx->stats)
+    start = simpleStatsNow();
+#endif
+
+  if(bank->config)
+    endian = bank->config->endian;
+
+  /* Swap the whole bank now, so the rest is native */
+  if(bank->swapMode != SIMPLE_SWAP_NONE)
+    {
+      if(!bank->swapped)
+	{
+	  (*kernel->swap32)(bank->bankBase,
+			    (const unsigned int *)simpleEventPtr(ctx, data, bank->bank.index),
+			    bank->wrap);
+
+	  /* The rest, after the end of a ring.  Swapped into the buffer, it
+	     no longer wraps */
+	  if(bank->wrap < bank->bank.length)
+	    {
+	      if(bank->swapMode == SIMPLE_SWAP_BUFFER)
+		{
+		  (*kernel->swap32)(&bank->bankBase[bank->wrap], bank->wrapBase,
+				    bank->bank.length - bank->wrap);
+		  bank->wrap = bank->bank.length;
+		}
+	      else
+		(*kernel->swap32)(bank->wrapBase, bank->wrapBase,
+				  bank->bank.length - bank->wrap);
+	    }
+	  bank->swapped = 1;
+	}
+      endian = 0;
+    }
+
+  if(!bank->config || bank->config->isBlocked)
+    {
+      /* Hand the bank, as it is now, to its scan routine */
+      scan.bank      = bank;
+      scan.data      = bank->bankBase;
+      scan.nwords    = bank->bank.length;
+      scan.index     = bank->bank.index;
+      scan.endian    = endian;
+      scan.debugMask = ctx->debugMask;
+      scan.validate  = ctx->validate;
+      scan.pool      = slotPool;
+      scan.count     = &bank->count;
+      scan.trace     = ctx->trace;
+      scan.ctx       = ctx;
+      scan.wrap      = bank->wrap;
+      scan.wrapData  = bank->wrapBase;
+
+      scanRoutine = simpleScanJLab;
+      if(bank->config && bank->config->firstPassRoutine &&
+	 (bank->config->firstPassRoutine != (void *)simpleScanBank))
+	scanRoutine = (simpleScanRoutine)bank->config->firstPassRoutine;
+
+      rval = (*scanRoutine)(&scan);
+    }
+  bank->count.status = rval;
+
+#ifdef SIMPLE_STATS
+  if(ctx->stats)
+    {
+      bank->count.nsec = simpleStatsNow() - start;
+
+      /* Workers of simpleScanBanksParallel() leave theirs to be added after */
+      if(slotPool == &ctx->slotPool)
+	simpleStatsAddBank(ctx, bank);
+    }
+#endif
+
+  return rval;
+}
+
+/**
+ * @ingroup Unblock
+ * @brief Slot data for a slot of the bank being scanned, for use in a
+ *    firstPassRoutine.  Cleared if the slot is new to this bank.
+ *
+ * @param scan  Bank being scanned
+ * @param slot  Slot number
+ *
+ * @return Slot data if successful, otherwise NULL
+ */
+slotDataInfo *
+simpleScanAddSlot(simpleBankScan *scan, int slot)
+{
+  return simpleBankSlot((simplePool *)scan->pool, scan->bank, slot);
+}
+
+/**
+ * @ingroup Unblock
+ * @brief Add an event to a slot of the bank being scanned, for use in a
+ *    firstPassRoutine.  Room for the events is taken by the block level
+ *    (bank->blkLevel), and grown if there are more.
+ *
+ * @param scan  Bank being scanned
+ * @param sd    Slot data, from simpleScanAddSlot()
+ *
+ * @return The new event (index and length 0) if successful, otherwise NULL
+ */
+simpleEventData *
+simpleScanAddEvent(simpleBankScan *scan, slotDataInfo *sd)
+{
+  simpleEventData *evt;
+  int maxEvents;
+
+  if(sd->nevents == sd->maxEvents)
+    {
+      if(sd->nevents > SIMPLE_MAX_BLOCKLEVEL)
+	return NULL;
+
+      if(sd->maxEvents)
+	maxEvents = 2 * sd->maxEvents;
+      else
+	maxEvents = (scan->bank->blkLevel > 0) ? scan->bank->blkLevel : 1;
+      if(maxEvents > SIMPLE_MAX_BLOCKLEVEL + 1)
+	maxEvents = SIMPLE_MAX_BLOCKLEVEL + 1;
+
+      evt = simplePoolAllocEvents((simplePool *)scan->pool, maxEvents);
+      if(evt == NULL)
+	{
+	  simpleScanError(scan, SIMPLE_ERROR_ALLOC, -1, 0, -1, maxEvents, 0);
+	  return NULL;
+	}
+      if(sd->nevents)
+	memcpy(evt, sd->evt, sd->nevents * sizeof(simpleEventData));
+
+      sd->evt = evt;
+      sd->maxEvents = maxEvents;
+    }
+
+  evt = &sd->evt[sd->nevents++];
+  evt->index  = 0;
+  evt->length = 0;
+
+  return evt;
+}
+
+/**
+ * @ingroup Unblock
+ * @brief Record an error found in the bank being scanned, for use in a
+ *    firstPassRoutine.  It is counted and kept for simpleGetErrors(),
+ *    and printed if the print rate of the context allows.
+ *
+ * @param scan      Bank being scanned
+ * @param code      simpleErrorCode
+ * @param index     Index of the word from the start of the event, or -1
+ * @param word      The word
+ * @param slot      Slot number, or -1
+ * @param value     What was found
+ * @param expected  What was expected
+ */
+void
+simpleScanError(simpleBankScan *scan, int code, int index, unsigned int word,
+		int slot, int value, int expected)
+{
+  if(scan->ctx == NULL)
+    return;
+
+  simpleCtxError(scan->ctx, code, index, word, scan->bank->rocID, scan->bank->bankID,
+		 slot, value, expected);
+}
+
+/* simpleDebug bit that shows each kind of trace record */
+static const int simpleTraceShow[SIMPLE_TRACE_NKINDS] =
+  {
+    [SIMPLE_TRACE_EVENT]         = 0,
+    [SIMPLE_TRACE_TRIGGER_BANK]  = SIMPLE_SHOW_BANK_FOUND,
+    [SIMPLE_TRACE_SEGMENT]       = SIMPLE_SHOW_SEGMENT_FOUND,
+    [SIMPLE_TRACE_ROC_BANK]      = SIMPLE_SHOW_BANK_FOUND,
+    [SIMPLE_TRACE_DATA_BANK]     = SIMPLE_SHOW_BANK_FOUND,
+    [SIMPLE_TRACE_FLAT_BANK]     = SIMPLE_SHOW_BANK_FOUND,
+    [SIMPLE_TRACE_IGNORED_BANK]  = SIMPLE_SHOW_IGNORED_BANKS,
+    [SIMPLE_TRACE_BLOCK_HEADER]  = SIMPLE_SHOW_BLOCK_HEADER,
+    [SIMPLE_TRACE_BLOCK_TRAILER] = SIMPLE_SHOW_BLOCK_TRAILER,
+    [SIMPLE_TRACE_EVENT_HEADER]  = SIMPLE_SHOW_EVENT_HEADER,
+    [SIMPLE_TRACE_TI_EVENT]      = SIMPLE_SHOW_EVENT_HEADER,
+    [SIMPLE_TRACE_SCALER_HEADER] = SIMPLE_SHOW_SCALER_HEADER,
+    [SIMPLE_TRACE_OTHER]         = SIMPLE_SHOW_OTHER
+  };
+
+/**
+ * @ingroup Unblock
+ * @brief Add a word to the trace, and print it if debugMask has the bit
+ *    for its kind.  Called through SIMPLE_TRACE_WORD(), which leaves
+ *    nothing behind in builds without SIMPLE_TRACE.
+ *
+ *    Scans of one context in several threads (parallel bank scanning)
+ *    each take the next record with an atomic add, without a lock.  A
+ *    ring too small for one event may be lapped, and its records mixed.
+ *
+ * @param trace      Trace of the context, or NULL
+ * @param debugMask  simpleDebug mask of the context
+ * @param kind       simpleTraceKind
+ * @param index      Index of the word from the start of the event
+ * @param word       The word
+ * @param arg        Depends on kind (bank length, ...)
+ */
+void
+simpleTraceWord(simpleTrace *trace, int debugMask, int kind, int index,
+		unsigned int word, unsigned int arg)
+{
+  simpleTraceRecord rec;
+  unsigned long long pos;
+
+  rec.index = index;
+  rec.word  = word;
+  rec.arg   = arg;
+  rec.kind  = kind;
+
+  if(trace)
+    {
+      pos = __atomic_fetch_add(&trace->head, 1, __ATOMIC_RELAXED);
+      trace->record[pos & trace->mask] = rec;
+    }
+
+  if((kind >= 0) && (kind < SIMPLE_TRACE_NKINDS) && (debugMask & simpleTraceShow[kind]))
+    simplePrintTrace(&rec, 1);
+}
+
+/* Index a data bank found by the last scan, if it has not been yet */
+static inline void
+simpleIndexBank(simpleCtx *ctx, bankDataInfo *bank)
+{
+  if(!bank->indexed && (bank->bank.length > 0))
+    simpleScanBankData(ctx, &ctx->slotPool, (volatile unsigned int *)ctx->dataAddr,
+		       bank->rocID, bank->bankID);
+}
+
+#define CHECKROCID(x,y)				\
+  {						\
+    bank = simpleFindBank(ctx, x,y);			\
+    if((bank != NULL) && ctx->lazy)		\
+      simpleIndexBank(ctx, bank);		\
+    if((bank == NULL) || !bank->indexed)	\
+      return -1;				\
+  }
+
+/* Address of the word at index (from the start of the event) of a data bank.
+   The bank may have been swapped into the swap buffer, or wrap around a ring */
+#define SIMPLE_BANK_WORD(b,idx)						\
+  (((idx) - (b)->bank.index < (b)->wrap) ?				\
+   &(b)->bankBase[(idx) - (b)->bank.index] :				\
+   &(b)->wrapBase[(idx) - (b)->bank.index - (b)->wrap])
+
+/* Words [idx, idx + len) of a data bank straddle the end of a ring */
+#define SIMPLE_BANK_WRAPS(b,idx,len)					\
+  (((idx) - (b)->bank.index < (b)->wrap) &&				\
+   ((idx) - (b)->bank.index + (len) > (b)->wrap))
+
+/* The len words at index of a data bank, in one or two parts */
+static void
+simpleBankSpan(const bankDataInfo *bank, int index, int len, simpleSpan *span)
+{
+  span->data[0]   = SIMPLE_BANK_WORD(bank, index);
+  span->length[0] = len;
+  span->data[1]   = NULL;
+  span->length[1] = 0;
+
+  if(SIMPLE_BANK_WRAPS(bank, index, len))
+    {
+      span->length[0] = bank->wrap - (index - bank->bank.index);
+      span->data[1]   = bank->wrapBase;
+      span->length[1] = len - span->length[0];
+    }
+}
+
+/* Block header or trailer word at index of a data bank.  A slot without one
+   has index 0, before the bank: read that from the event, as the bank's
+   base may be in a ring or the swap buffer */
+static inline unsigned int
+simpleBlockWord(const simpleCtx *ctx, const bankDataInfo *bank, int index)
+{
+  if(index < bank->bank.index)
+    return simpleEventWord(ctx, (volatile unsigned int *)ctx->dataAddr, index);
+
+  return *SIMPLE_BANK_WORD(bank, index);
+}
+
+#define CHECKSLOT(x)					\
+  {							\
+    if( ((x) < 0) || ((x) >= SIMPLE_MAX_SLOTS) ||	\
+	((bank->slotMask & (1 << (x))) == 0) )		\
+      return -1;					\
+  }
+
+
+/* Data access routines */
+
+/**
+ * @ingroup Data Access
+ * @brief Return the rocIDs of the ROC banks found in the last event
+ *
+ * @param ctx        Scan context
+ * @param *rocList   Where to store the rocIDs (up to SIMPLE_MAX_ROCS)
+ *
+ * @return Number of ROC banks
+ */
+int
+simpleCtxGetRocList(simpleCtx *ctx, int *rocList)
+{
+  int iroc;
+
+  for(iroc = 0; iroc < ctx->nRocs; iroc++)
+    rocList[iroc] = ctx->rocList[iroc];
+
+  return ctx->nRocs;
+}
+
+/**
+ * @ingroup Data Access
+ * @brief Return the bank tags of the data banks found in a ROC bank
+ *
+ * @param ctx        Scan context
+ * @param rocID      Which ROC bank
+ * @param *bankList  Where to store the bank tags (up to SIMPLE_MAX_BANKS)
+ *
+ * @return Number of data banks if successful, otherwise ERROR
+ */
+int
+simpleCtxGetBankList(simpleCtx *ctx, int rocID, int *bankList)
+{
+  rocBankInfo *roc;
+  int ibank, nbanks = 0;
+
+  if((rocID < 0) || (rocID >= SIMPLE_MAX_ROCS))
+    return ERROR;
+
+  roc = &ctx->rocBank[rocID];
+  if(roc->length <= 0)
+    return ERROR;
+
+  for(ibank = 0; ibank < roc->nbanks; ibank++)
+    if(roc->dataBank[ibank]->bank.length > 0)
+      bankList[nbanks++] = roc->dataBank[ibank]->bankID;
+
+  return nbanks;
+}
+
+int
+simpleCtxGetRocBanks(simpleCtx *ctx, int rocID, int bankID, int *bankList)
+{
+  bankDataInfo *bank;
+
+  CHECKROCID(rocID,bankID);
+
+  return 0;
+}
+
+/**
+ * @ingroup Data Access
+ * @brief Return the slotmask from the specified rocID and bankID
+ *
+ * @param ctx        Scan context
+ * @param rocID      Which ROC bank to find the slotmask
+ * @param bankID     Which Bank to find the slotmask
+ * @param *slotmask  Where to store the slotmask
+ *
+ * @return 1 if successful, otherwise ERROR
+ */
+
+int
+simpleCtxGetRocSlotmask(simpleCtx *ctx, int rocID, int bankID, unsigned int *slotmask)
+{
+  bankDataInfo *bank;
+
+  CHECKROCID(rocID,bankID);
+
+  *slotmask = bank->slotMask;
+
+  return 1;
+}
+
+/**
+ * @ingroup Data Access
+ * @brief Return the buffer to the part of the data with specified rocID,
+ *         bankID.  Use for unblocked Banks.
+ *
+ * @param ctx        Scan context
+ * @param rocID        Which ROC bank to find the buffer
+ * @param bankID       Which Bank to find the buffer
+ * @param **buffer     Where to store the address of the buffer
+ *
+ * @return Length of the buffer if successful, otherwise ERROR.  ERROR if
+ *         it wraps around a ring (simpleCtxGetRocBankSpan()).
+ */
+
+int
+simpleCtxGetRocBankData(simpleCtx *ctx, int rocID, int bankID, unsigned int **buffer)
+{
+  int length = 0;
+  unsigned long addr = 0;
+  bankDataInfo *bank;
+
+  CHECKROCID(rocID, bankID);
+
+  if(bank->wrap < bank->bank.length)
+    return -1;
+
+  addr = (unsigned long)bank->bankBase;
+  *buffer = (unsigned int *) addr;
+
+  length = bank->bank.length;
+
+  return length;
+}
+
+/**
+ * @ingroup Data Access
+ * @brief Return the data of the bank with specified rocID, bankID, in two
+ *    parts if it wraps around the end of the ring of simpleCtxScanRing().
+ *
+ * @param ctx        Scan context
+ * @param rocID      Which ROC bank to find the data
+ * @param bankID     Which Bank to find the data
+ * @param *span      Where to store the parts of the data
+ *
+ * @return Length of the data if successful, otherwise ERROR
+ */
+int
+simpleCtxGetRocBankSpan(simpleCtx *ctx, int rocID, int bankID, simpleSpan *span)
+{
+  bankDataInfo *bank;
+
+  CHECKROCID(rocID, bankID);
+
+  simpleBankSpan(bank, bank->bank.index, bank->bank.length, span);
+
+  return bank->bank.length;
+}
+
+/**
+ * @ingroup Data Access
+ * @brief Return the events of every slot of a bank, event by event.
+ *
+ *    view[evt * nslots + i] is event evt of the i-th slot in the slot mask
+ *    (lowest slot first), so the slots of one event are next to each
+ *    other.  index is the word of the event's data from the start of the
+ *    bank's data (simpleGetRocBankData(), or simpleGetRocBankSpan()).  Slots
+ *    without event evt have length 0.  The view is built by the first call
+ *    after a scan.
+ *
+ * @param ctx        Scan context
+ * @param rocID      Which ROC bank
+ * @param bankID     Which Bank
+ * @param **view     Where to store the address of the view
+ * @param *nslots    Where to store the number of slots in each event
+ *
+ * @return Number of events in the view if successful, otherwise ERROR
+ */
+int
+simpleCtxGetRocEventView(simpleCtx *ctx, int rocID, int bankID,
+			 const simpleEventData **view, int *nslots)
+{
+  int islot, ievt, nevents = 0, n = 0, iview;
+  simpleEventData *ev;
+  slotDataInfo *sd;
+  bankDataInfo *bank;
+
+  CHECKROCID(rocID, bankID);
+
+  if(bank->evtView == NULL)
+    {
+      for(islot = 0; islot < SIMPLE_MAX_SLOTS; islot++)
+	{
+	  if((bank->slotMask & (1u << islot)) == 0)
+	    continue;
+	  if(bank->slot[islot]->nevents > nevents)
+	    nevents = bank->slot[islot]->nevents;
+	  n++;
+	}
+
+      ev = simplePoolAllocEvents(&ctx->slotPool, (n * nevents > 0) ? n * nevents : 1);
+      if(ev == NULL)
+	{
+	  printf("%s: ERROR: Unable to allocate view of %d events\n", __func__, n * nevents);
+	  return -1;
+	}
+      memset(ev, 0, n * nevents * sizeof(simpleEventData));
+
+      bank->evtView    = ev;
+      bank->viewSlots  = n;
+      bank->viewEvents = nevents;
+
+      iview = 0;
+      for(islot = 0; islot < SIMPLE_MAX_SLOTS; islot++)
+	{
+	  if((bank->slotMask & (1u << islot)) == 0)
+	    continue;
+	  sd = bank->slot[islot];
+	  for(ievt = 0; ievt < sd->nevents; ievt++)
+	    {
+	      ev[ievt * n + iview].index  = sd->evt[ievt].index - bank->bank.index;
+	      ev[ievt * n + iview].length = sd->evt[ievt].length;
+	    }
+	  iview++;
+	}
+    }
+
+  *view   = bank->evtView;
+  *nslots = bank->viewSlots;
+
+  return bank->viewEvents;
+}
+
+/**
+ * @ingroup Data Access
+ * @brief Return the block level from the specified rocID and bankID
+ *
+ * @param ctx        Scan context
+ * @param rocID        Which ROC bank to find the block level
+ * @param bankID       Which Bank to find the block level
+ * @param *blockLevel  Where to store the block level
+ *
+ * @return 1 if successful, otherwise ERROR
+ */
+
+int
+simpleCtxGetRocBlockLevel(simpleCtx *ctx, int rocID, int bankID, int *blockLevel)
+{
+  bankDataInfo *bank;
+
+  CHECKROCID(rocID, bankID);
+
+  *blockLevel = bank->blkLevel;
+
+  return 1;
+}
+
+/**
+ * @ingroup Data Access
+ * @brief Return how the specified rocID and bankID is byte swapped, as
+ *        configured with simpleConfigBankSwap().  SIMPLE_SWAP_NONE if it
+ *        is not a big endian bank.  A SIMPLE_SWAP_BUFFER bank is left as
+ *        it is in the event if the swap buffer had no room for it.
+ *
+ * @param ctx        Scan context
+ * @param rocID        Which ROC bank
+ * @param bankID       Which Bank
+ * @param *swapMode    Where to store SIMPLE_SWAP_NONE, _INPLACE or _BUFFER
+ *
+ * @return 1 if successful, otherwise ERROR
+ */
+
+int
+simpleCtxGetRocBankSwap(simpleCtx *ctx, int rocID, int bankID, int *swapMode)
+{
+  bankDataInfo *bank;
+
+  CHECKROCID(rocID, bankID);
+
+  if(bank->config && bank->config->endian)
+    *swapMode = bank->config->swapMode;
+  else
+    *swapMode = SIMPLE_SWAP_NONE;
+
+  return 1;
+}
+
+/**
+ * @ingroup Data Access
+ * @brief Return the block header from the specified rocID, bankID, and slot number
+ *
+ * @param ctx        Scan context
+ * @param rocID        Which ROC bank to find the block header
+ * @param bankID       Which Bank to find the block header
+ * @param slot         Which slot to find the block header
+ * @param *header      Where to store the block header
+ *
+ * @return 1 if successful, otherwise ERROR
+ */
+
+int
+simpleCtxGetSlotBlockHeader(simpleCtx *ctx, int rocID, int bankID, int slot, unsigned int *header)
+{
+  int index;
+  bankDataInfo *bank;
+
+  CHECKROCID(rocID, bankID);
+  CHECKSLOT(slot);
+
+  index = bank->slot[slot]->blkIndex;
+  *header = simpleBlockWord(ctx, bank, index);
+
+  return 1;
+}
+
+
+/**
+ * @ingroup Data Access
+ * @brief Return the Event header from the specified rocID, bankID, and slot
+ *        for the specified event within a block
+ *
+ * @param ctx        Scan context
+ * @param rocID        Which ROC bank to find the event header
+ * @param bankID       Which Bank to find the event header
+ * @param slot         Which slot to find the event header
+ * @param evt          Which event within the block to find the event header
+ * @param *header  Where to store the event header
+ *
+ * @return 1 if successful, otherwise ERROR
+ */
+
+int
+simpleCtxGetSlotEventHeader(simpleCtx *ctx, int rocID, int bankID, int slot, int evt, unsigned int *header)
+{
+  int index;
+  bankDataInfo *bank;
+
+  CHECKROCID(rocID, bankID);
+  CHECKSLOT(slot);
+
+  if((evt < 0) || (evt >= bank->slot[slot]->nevents))
+    return -1;
+
+  index = bank->slot[slot]->evt[evt].index;
+  *header = *SIMPLE_BANK_WORD(bank, index);
+
+  return 1;
+}
+
+/**
+ * @ingroup Data Access
+ * @brief Return the buffer to the part of the data with specified rocID,
+ *         bankID, and slot number, and event of the block.
+ *
+ * @param ctx        Scan context
+ * @param rocID        Which ROC bank to find the buffer
+ * @param bankID       Which Bank to find the buffer
+ * @param slot         Which slot to find the buffer
+ * @param evt          Which event within the block to find the buffer
+ * @param **buffer     Where to store the address of the buffer
+ *
+ * @return Length of the buffer if successful, otherwise ERROR.  ERROR if
+ *         it wraps around a ring (simpleCtxGetSlotEventSpan()).
+ */
+
+int
+simpleCtxGetSlotEventData(simpleCtx *ctx, int rocID, int bankID, int slot, int evt, unsigned int **buffer)
+{
+  int length = 0;
+  unsigned long addr = 0;
+  bankDataInfo *bank;
+
+  CHECKROCID(rocID, bankID);
+  CHECKSLOT(slot);
+
+  if((evt < 0) || (evt >= bank->slot[slot]->nevents))
+    return -1;
+
+  if(SIMPLE_BANK_WRAPS(bank, bank->slot[slot]->evt[evt].index,
+		       bank->slot[slot]->evt[evt].length))
+    return -1;
+
+  addr = (unsigned long)SIMPLE_BANK_WORD(bank, bank->slot[slot]->evt[evt].index);
+  *buffer = (unsigned int *) addr;
+
+  length = bank->slot[slot]->evt[evt].length;
+
+  return length;
+}
+
+/**
+ * @ingroup Data Access
+ * @brief Return the data of an event of the block from the specified rocID,
+ *    bankID, and slot number, in two parts if it wraps around the end of
+ *    the ring of simpleCtxScanRing().
+ *
+ * @param ctx        Scan context
+ * @param rocID      Which ROC bank to find the data
+ * @param bankID     Which Bank to find the data
+ * @param slot       Which slot to find the data
+ * @param evt        Which event within the block to find the data
+ * @param *span      Where to store the parts of the data
+ *
+ * @return Length of the data if successful, otherwise ERROR
+ */
+int
+simpleCtxGetSlotEventSpan(simpleCtx *ctx, int rocID, int bankID, int slot, int evt,
+			  simpleSpan *span)
+{
+  bankDataInfo *bank;
+
+  CHECKROCID(rocID, bankID);
+  CHECKSLOT(slot);
+
+  if((evt < 0) || (evt >= bank->slot[slot]->nevents))
+    return -1;
+
+  simpleBankSpan(bank, bank->slot[slot]->evt[evt].index,
+		 bank->slot[slot]->evt[evt].length, span);
+
+  return bank->slot[slot]->evt[evt].length;
+}
+
+/**
+ * @ingroup Data Access
+ * @brief Return the block trailer from the specified rocID, bankID, and slot number
+ *
+ * @param ctx        Scan context
+ * @param rocID        Which ROC bank to find the block trailer
+ * @param bankID       Which Bank to find the block trailer
+ * @param slot         Which slot to find the block trailer
+ * @param *trailer     Where to store the block trailer
+ *
+ * @return 1 if successful, otherwise ERROR
+ */
+
+int
+simpleCtxGetSlotBlockTrailer(simpleCtx *ctx, int rocID, int bankID, int slot, unsigned int *trailer)
+{
+  int index;
+  bankDataInfo *bank;
+
+  CHECKROCID(rocID, bankID);
+  CHECKSLOT(slot);
+
+  index = bank->slot[slot]->blkTrailerIndex;
+  *trailer = simpleBlockWord(ctx, bank, index);
+
+  return 1;
+}
+
+/**
+ * @ingroup Data Access
+ * @brief Return the buffer to the Trigger Bank's Run number and Timestamp segment
+ *
+ * @param ctx        Scan context
+ * @param **buffer     Where to store the address of the buffer
+ *
+ * @return Length of the buffer if successful, otherwise ERROR
+ */
+
+int
+simpleCtxGetTriggerBankTimeSegment(simpleCtx *ctx, unsigned long long **buffer)
+{
+  int len = 0;
+  unsigned long addr = (unsigned long)simpleEventAddr(ctx, ctx->trigBank.segTime.index,
+						      ctx->trigBank.segTime.header.bf.num);
+
+  if(addr == 0)
+    return -1;
+
+  *buffer = (unsigned long long int *)addr;
+  len = ctx->trigBank.segTime.header.bf.num >> 1;
+
+  return len;
+}
+
+/**
+ * @ingroup Data Access
+ * @brief Return the buffer to the Trigger Bank's Event Type segment
+ *
+ * @param ctx        Scan context
+ * @param **buffer     Where to store the address of the buffer
+ *
+ * @return Length of the buffer if successful, otherwise ERROR
+ */
+
+int
+simpleCtxGetTriggerBankTypeSegment(simpleCtx *ctx, unsigned short **buffer)
+{
+  int len = 0;
+  unsigned long addr = (unsigned long)simpleEventAddr(ctx, ctx->trigBank.segEvType.index,
+						      ctx->trigBank.segEvType.header.bf.num);
+
+  if(addr == 0)
+    return -1;
+
+  *buffer = (unsigned short *)addr;
+  len = ctx->trigBank.segEvType.header.bf.num << 1;
+
+  return len;
+}
+
+/**
+ * @ingroup Data Access
+ * @brief Return the buffer to the Trigger Bank's ROC segment
+ *
+ * @param ctx        Scan context
+ * @param rocID        Which roc ID to find the buffer
+ * @param **buffer     Where to store the address of the buffer
+ *
+ * @return Length of the buffer if successful, otherwise ERROR
+ */
+
+int
+simpleCtxGetTriggerBankRocSegment(simpleCtx *ctx, int rocID, unsigned int **buffer)
+{
+  int len = 0;
+  unsigned long addr = 0;
+
+  if((rocID < 0) || (rocID >= SIMPLE_MAX_ROCS) ||
+     (ctx->trigBank.segRoc[rocID].header.bf.tag != rocID))
+    {
+      return -1;
+    }
+
+  addr = (unsigned long)simpleEventAddr(ctx, ctx->trigBank.segRoc[rocID].index,
+					ctx->trigBank.segRoc[rocID].header.bf.num);
+  if(addr == 0)
+    return -1;
+
+  *buffer = (unsigned int *) addr;
+
+  len = ctx->trigBank.segRoc[rocID].header.bf.num;
+
+  return len;
+}
+
+/* Fill the columns of events [offset, offset + nevents) from the time segment
+   (ntime 64 bit words, first the event number, then the timestamps if
+   hasTimestamp) and event type segment (ntype 16 bit words).
+   The segments are in the other byte order if swapped. */
+static void
+simpleTriggerFill(const unsigned int *time, int ntime, int hasTimestamp,
+		  const unsigned short *type, int ntype, int nevents, int swapped,
+		  simpleTriggerColumns *cols, int offset)
+{
+  const simpleKernel *kernel = simpleKernelGet();
+  unsigned long long first = 0, *ts;
+  int ievt, n;
+
+  if(cols->evnum)
+    {
+      if(ntime > 0)
+	{
+	  if(swapped)
+	    kernel->swap64(&first, time, 1);
+	  else
+	    memcpy(&first, time, sizeof(first));
+	}
+      for(ievt = 0; ievt < nevents; ievt++)
+	cols->evnum[offset + ievt] = (ntime > 0) ? first + ievt : 0;
+    }
+
+  if(cols->timestamp)
+    {
+      ts = &cols->timestamp[offset];
+      n = hasTimestamp ? ntime - 1 : 0;
+      if(n > nevents)
+	n = nevents;
+      if(n < 0)
+	n = 0;
+
+      /* 64 bit words may not be aligned */
+      if(swapped)
+	kernel->swap64(ts, &time[2], n);
+      else
+	memcpy(ts, &time[2], n * sizeof(unsigned long long));
+
+      if((cols->timestampBits > 0) && (cols->timestampBits < 64))
+	{
+	  unsigned long long mask = (1ULL << cols->timestampBits) - 1;
+	  for(ievt = 0; ievt < n; ievt++)
+	    ts[ievt] &= mask;
+	}
+
+      for(ievt = n; ievt < nevents; ievt++)
+	ts[ievt] = 0;
+    }
+
+  if(cols->type)
+    {
+      n = (ntype < nevents) ? ntype : nevents;
+
+      if(swapped)
+	kernel->swap16(&cols->type[offset], type, n);
+      else
+	memcpy(&cols->type[offset], type, n * sizeof(unsigned short));
+
+      for(ievt = n; ievt < nevents; ievt++)
+	cols->type[offset + ievt] = SIMPLE_TRIGGER_NO_TYPE;
+    }
+}
+
+/**
+ * @ingroup Data Access
+ * @brief Fill the trigger bank columns of the events of the scanned block:
+ *    event number, timestamp and event type, one array entry per event.
+ *
+ * @param ctx        Scan context
+ * @param *cols      Arrays to fill.  Any may be NULL, to skip that column.
+ * @param offset     Entry of the arrays for the first event of the block
+ *
+ * @return Number of events filled if successful, otherwise ERROR
+ */
+int
+simpleCtxGetTriggerColumns(simpleCtx *ctx, simpleTriggerColumns *cols, int offset)
+{
+  volatile unsigned int *data = (volatile unsigned int *)ctx->dataAddr;
+  const unsigned int *time, *type;
+  int nevents;
+
+  if((data == NULL) || (ctx->trigBank.length == 0))
+    {
+      printf("%s: ERROR: No trigger bank scanned\n", __func__);
+      return ERROR;
+    }
+
+  nevents = simpleEventWord(ctx, data, 1) & 0xFF;	/* Block level of the CODA event */
+  if((cols == NULL) || (offset < 0) || (offset + nevents > cols->max))
+    {
+      printf("%s: ERROR: No room for %d events at offset %d\n", __func__, nevents, offset);
+      return ERROR;
+    }
+
+  time = simpleEventAddr(ctx, ctx->trigBank.segTime.index,
+			 ctx->trigBank.segTime.header.bf.num);
+  type = simpleEventAddr(ctx, ctx->trigBank.segEvType.index,
+			 ctx->trigBank.segEvType.header.bf.num);
+  if((time == NULL) || (type == NULL))
+    {
+      printf("%s: ERROR: Trigger bank segment wraps around the ring\n", __func__);
+      return ERROR;
+    }
+
+  simpleTriggerFill(time, ctx->trigBank.segTime.header.bf.num >> 1,
+		    ctx->trigBank.header.bf.tag & 0x1,
+		    (const unsigned short *)type,
+		    ctx->trigBank.segEvType.header.bf.num << 1,
+		    nevents, 0, cols, offset);
+
+  return nevents;
+}
+
+/**
+ * @ingroup Data Access
+ * @brief Fill the trigger bank columns of a block straight from its trigger
+ *    bank, without a scan.  The bank may have the other byte order.
+ *
+ * @param *bank      Trigger bank, from its length word
+ * @param nevents    Events in the block (block level of the CODA event)
+ * @param swapped    1 if the bank has the other byte order, otherwise 0
+ * @param *cols      Arrays to fill.  Any may be NULL, to skip that column.
+ * @param offset     Entry of the arrays for the first event of the block
+ *
+ * @return Number of events filled if successful, otherwise ERROR
+ */
+int
+simpleTriggerBankColumns(const unsigned int *bank, int nevents, int swapped,
+			 simpleTriggerColumns *cols, int offset)
+{
+  const unsigned int *time = NULL, *type = NULL;
+  int iword, len, ntime = 0, ntype = 0;
+  bankHeader_t header;
+  segmentHeader_t sh;
+
+  if((bank == NULL) || (cols == NULL) || (nevents < 0) ||
+     (offset < 0) || (offset + nevents > cols->max))
+    {
+      printf("%s: ERROR: No room for %d events at offset %d\n", __func__, nevents, offset);
+      return ERROR;
+    }
+
+  len        = swapped ? bswap_32(bank[0]) : bank[0];
+  header.raw = swapped ? bswap_32(bank[1]) : bank[1];
+  if((len < 1) || (header.bf.type != EVIO_SEGMENT))
+    {
+      printf("%s: ERROR: Not a trigger bank (length %d, header 0x%08x)\n",
+	     __func__, len, header.raw);
+      return ERROR;
+    }
+
+  /* Only the time and event type segments */
+  iword = 2;
+  while(iword <= len)
+    {
+      sh.raw = swapped ? bswap_32(bank[iword]) : bank[iword];
+      iword++;
+
+      if(iword + sh.bf.num > len + 1)
+	{
+	  printf("%s: ERROR: Segment length %d runs past the end of the trigger bank\n",
+		 __func__, sh.bf.num);
+	  return ERROR;
+	}
+
+      if(sh.bf.type == EVIO_ULONG64)
+	{
+	  time  = &bank[iword];
+	  ntime = sh.bf.num >> 1;
+	}
+      else if(sh.bf.type == EVIO_USHORT16)
+	{
+	  type  = &bank[iword];
+	  ntype = sh.bf.num << 1;
+	}
+
+      iword += sh.bf.num;
+    }
+
+  simpleTriggerFill(time, ntime, header.bf.tag & 0x1,
+		    (const unsigned short *)type, ntype, nevents, swapped, cols, offset);
+
+  return nevents;
+}
+
+/**
+ * @ingroup Data Access
+ * @brief Return the banks stepped over by simpleConfigIgnoreUndefinedBlocks(),
+ *    with the number of times and words of data each was skipped since the
+ *    context was created (or simpleCtxResetSkipCounts()).
+ *
+ * @param ctx      Scan context
+ * @param *list    Where to store the counts
+ * @param max      Size of list
+ *
+ * @return Number of banks skipped (may be more than max)
+ */
+int
+simpleCtxGetSkipCounts(simpleCtx *ctx, simpleSkipCount *list, int max)
+{
+  int i;
+
+  for(i = 0; (i < ctx->nSkipCount) && (i < max); i++)
+    list[i] = ctx->skipCount[i];
+
+  return ctx->nSkipCount;
+}
+
+/**
+ * @ingroup Data Access
+ * @brief Clear the counts of simpleCtxGetSkipCounts()
+ *
+ * @param ctx      Scan context
+ */
+void
+simpleCtxResetSkipCounts(simpleCtx *ctx)
+{
+  ctx->nSkipCount = 0;
+  ctx->skipCountNext = 0;
+}
+
+/**
+ * @ingroup Data Access
+ * @brief Return the scan statistics counted since stats were turned on
+ *    with simpleCtxConfigStats() (or simpleCtxResetStats()).
+ *
+ * @param ctx      Scan context
+ * @param *stats   Where to store them
+ *
+ * @return OK if successful, otherwise ERROR
+ */
+int
+simpleCtxGetStats(simpleCtx *ctx, simpleStats *stats)
+{
+  if(stats == NULL)
+    {
+      printf("%s: ERROR: Invalid stats pointer\n", __func__);
+      return ERROR;
+    }
+
+  *stats = ctx->stat;
+
+  return OK;
+}
+
+/**
+ * @ingroup Data Access
+ * @brief Return the scan statistics of each data bank indexed, in the
+ *    order they were first found.
+ *
+ * @param ctx      Scan context
+ * @param *list    Where to store the stats
+ * @param max      Size of list
+ *
+ * @return Number of banks (may be more than max)
+ */
+int
+simpleCtxGetBankStats(simpleCtx *ctx, simpleBankStats *list, int max)
+{
+  int i;
+
+  for(i = 0; (i < ctx->nBankStats) && (i < max); i++)
+    list[i] = ctx->bankStats[i];
+
+  return ctx->nBankStats;
+}
+
+/**
+ * @ingroup Data Access
+ * @brief Clear the scan statistics of simpleCtxGetStats() and
+ *    simpleCtxGetBankStats()
+ *
+ * @param ctx      Scan context
+ */
+void
+simpleCtxResetStats(simpleCtx *ctx)
+{
+  memset(&ctx->stat, 0, sizeof(simpleStats));
+  ctx->nBankStats = 0;
+  ctx->bankStatsNext = 0;
+}
+
+/**
+ * @ingroup Data Access
+ * @brief Copy the most recent trace records of the scans of a context,
+ *    oldest first.  Call it between scans.
+ *
+ * @param ctx      Scan context
+ * @param *list    Where to store the records
+ * @param max      Size of list
+ *
+ * @return Number of records copied, 0 if not tracing
+ */
+int
+simpleCtxGetTrace(simpleCtx *ctx, simpleTraceRecord *list, int max)
+{
+  simpleTrace *trace = ctx->trace;
+  unsigned long long head, first;
+  int i, n;
+
+  if((trace == NULL) || (max <= 0))
+    return 0;
+
+  head = __atomic_load_n(&trace->head, __ATOMIC_ACQUIRE);
+  if(head > (unsigned long long)trace->mask + 1)
+    n = trace->mask + 1;
+  else
+    n = head;
+  if(n > max)
+    n = max;
+
+  first = head - n;
+  for(i = 0; i < n; i++)
+    list[i] = trace->record[(first + i) & trace->mask];
+
+  return n;
+}
+
+/**
+ * @ingroup Data Access
+ * @brief Print trace records, as the scan would have with the matching
+ *    simpleDebug bits set.
+ *
+ * @param *list    Records, from simpleGetTrace() (or a file of them)
+ * @param n        Number of records
+ */
+void
+simplePrintTrace(const simpleTraceRecord *list, int n)
+{
+  int i;
+
+  for(i = 0; i < n; i++)
+    {
+      const simpleTraceRecord *rec = &list[i];
+      bankHeader_t bh;
+      segmentHeader_t sh;
+      block_header_t bheader;
+      block_trailer_t btrailer;
+      event_header_t eheader;
+      scaler_header_t sheader;
+
+      bh.raw = sh.raw = bheader.raw = btrailer.raw = eheader.raw = sheader.raw = rec->word;
+
+      switch(rec->kind)
+	{
+	case SIMPLE_TRACE_EVENT:
+	  printf("[%6d  0x%08x] EVENT 0x%4x: Length = %d, nevents = %d\n",
+		 rec->index, rec->word, bh.bf.tag, rec->arg, bh.bf.num);
+	  break;
+
+	case SIMPLE_TRACE_TRIGGER_BANK:
+	  printf("[%6d  0x%08x] TRGB 0x%4x: Length = %d, nrocs = %d\n",
+		 rec->index, rec->word, bh.bf.type, rec->arg, bh.bf.num);
+	  break;
+
+	case SIMPLE_TRACE_SEGMENT:
+	  printf("[%6d  0x%08x] SEGM %2d: type = 0x%x, length = %d\n",
+		 rec->index, rec->word, sh.bf.tag, sh.bf.type, sh.bf.num);
+	  break;
+
+	case SIMPLE_TRACE_ROC_BANK:
+	  printf("[%6d  0x%08x] ROCB %2d: type = 0x%2x, Length = %d, blocklevel = %d\n",
+		 rec->index, rec->word, bh.bf.tag & 0x0FFF, bh.bf.type, rec->arg, bh.bf.num);
+	  break;
+
+	case SIMPLE_TRACE_DATA_BANK:
+	  printf("[%6d  0x%08x] BANK 0x%2x: Type = 0x%x Num = 0x%x Length = %d\n",
+		 rec->index, rec->word, bh.bf.tag, bh.bf.type, bh.bf.num, rec->arg);
+	  break;
+
+	case SIMPLE_TRACE_FLAT_BANK:
+	  printf("[%6d  0x%08x] FLAT BANK: Length = %d\n",
+		 rec->index, rec->word, rec->arg);
+	  break;
+
+	case SIMPLE_TRACE_IGNORED_BANK:
+	  printf("[%6d  0x%08x] IGNORED BANK 0x%2x: Type = 0x%x Num = 0x%x Length = %d\n",
+		 rec->index, rec->word, bh.bf.tag, bh.bf.type, bh.bf.num, rec->arg);
+	  break;
+
+	case SIMPLE_TRACE_BLOCK_HEADER:
+	  printf("[%6d  0x%08x] "
+		 "BLOCK HEADER: slot %2d, block_number %3d, block_level %3d\n",
+		 rec->index, rec->word, bheader.bf.slot_number,
+		 bheader.bf.event_block_number, bheader.bf.number_of_events_in_block);
+	  break;
+
+	case SIMPLE_TRACE_BLOCK_TRAILER:
+	  printf("[%6d  0x%08x] "
+		 "BLOCK TRAILER: slot %2d, nwords %d\n",
+		 rec->index, rec->word, btrailer.bf.slot_number, btrailer.bf.words_in_block);
+	  break;
+
+	case SIMPLE_TRACE_EVENT_HEADER:
+	  printf("[%6d  0x%08x] "
+		 "EVENT HEADER: trigger number %d\n",
+		 rec->index, rec->word, eheader.bf.event_number);
+	  break;
+
+	case SIMPLE_TRACE_TI_EVENT:
+	  printf("[%6d  0x%08x] "
+		 "TI EVENT: type %d, word count %d\n",
+		 rec->index, rec->word, (rec->word & TRIG_EVENT_HEADER_TYPE_MASK) >> 24,
+		 rec->word & TRIG_EVENT_HEADER_WORD_COUNT_MASK);
+	  break;
+
+	case SIMPLE_TRACE_SCALER_HEADER:
+	  printf("[%6d  0x%08x] "
+		 "SCALER HEADER: scaler_words = %d\n",
+		 rec->index, rec->word, sheader.bf.scaler_words);
+	  break;
+
+	case SIMPLE_TRACE_OTHER:
+	  printf("(%3d) OTHER: 0x%08x\n", rec->index, rec->word);
+	  break;
+
+	default:
+	  printf("[%6d  0x%08x] kind %d, arg %d\n",
+		 rec->index, rec->word, rec->kind, rec->arg);
+	}
+    }
+}
+
+/**
+ * @ingroup Data Access
+ * @brief Copy the most recent errors found by the scans of a context
+ *    (up to SIMPLE_MAX_ERRORS of them), oldest first.
+ *
+ * @param ctx      Scan context
+ * @param *list    Where to store the errors
+ * @param max      Size of list
+ *
+ * @return Number of errors copied
+ */
+int
+simpleCtxGetErrors(simpleCtx *ctx, simpleError *list, int max)
+{
+  unsigned long long head, first;
+  int i, n;
+
+  if(max <= 0)
+    return 0;
+
+  head = __atomic_load_n(&ctx->errorHead, __ATOMIC_ACQUIRE);
+  n = (head > SIMPLE_MAX_ERRORS) ? SIMPLE_MAX_ERRORS : head;
+  if(n > max)
+    n = max;
+
+  first = head - n;
+  for(i = 0; i < n; i++)
+    list[i] = ctx->error[(first + i) % SIMPLE_MAX_ERRORS];
+
+  return n;
+}
+
+/**
+ * @ingroup Data Access
+ * @brief Return the number of errors of each simpleErrorCode found by the
+ *    scans of a context, since it was created (or simpleCtxResetErrors()).
+ *
+ * @param ctx      Scan context
+ * @param *counts  Where to store the counts, indexed by simpleErrorCode
+ * @param max      Size of counts
+ *
+ * @return SIMPLE_ERROR_NCODES
+ */
+int
+simpleCtxGetErrorCounts(simpleCtx *ctx, unsigned long long *counts, int max)
+{
+  int i;
+
+  for(i = 0; (i < SIMPLE_ERROR_NCODES) && (i < max); i++)
+    counts[i] = ctx->errorCount[i];
+
+  return SIMPLE_ERROR_NCODES;
+}
+
+/**
+ * @ingroup Data Access
+ * @brief Clear the errors of simpleCtxGetErrors() and simpleCtxGetErrorCounts()
+ *
+ * @param ctx      Scan context
+ */
+void
+simpleCtxResetErrors(simpleCtx *ctx)
+{
+  ctx->errorHead = 0;
+  memset(ctx->errorCount, 0, sizeof(ctx->errorCount));
+}
+
+/**
+ * @ingroup Data Access
+ * @brief Describe an error code
+ *
+ * @param code     simpleErrorCode
+ *
+ * @return Description of the error
+ */
+const char *
+simpleErrorString(int code)
+{
+  static const char *errorString[SIMPLE_ERROR_NCODES] =
+    {
+      [SIMPLE_ERROR_NONE]            = "No error",
+      [SIMPLE_ERROR_EVENT_LENGTH]    = "Event length does not fit in buffer",
+      [SIMPLE_ERROR_BANK_TYPE]       = "Unexpected bank type",
+      [SIMPLE_ERROR_TRIGGER_LENGTH]  = "Trigger bank length past end of event",
+      [SIMPLE_ERROR_SEGMENT_LENGTH]  = "Segment length past end of trigger bank",
+      [SIMPLE_ERROR_SEGMENT_TYPE]    = "Unexpected segment type in trigger bank",
+      [SIMPLE_ERROR_TRIGGER_NROCS]   = "Trigger bank ROC segments != nrocs",
+      [SIMPLE_ERROR_ROC_ID]          = "rocID too large",
+      [SIMPLE_ERROR_ROC_LENGTH]      = "ROC bank length past end of event",
+      [SIMPLE_ERROR_BANK_LENGTH]     = "Bank length past end of ROC bank",
+      [SIMPLE_ERROR_ROC_END]         = "Banks do not end at end of ROC bank",
+      [SIMPLE_ERROR_EVENT_END]       = "ROC banks do not end at end of event",
+      [SIMPLE_ERROR_TOO_MANY_BANKS]  = "Too many banks in ROC",
+      [SIMPLE_ERROR_DUPLICATE_BANK]  = "Bank found again, skipped",
+      [SIMPLE_ERROR_ALLOC]           = "Unable to allocate index",
+      [SIMPLE_ERROR_BLOCK_LEVEL]     = "Block level != block level of first slot",
+      [SIMPLE_ERROR_TRAILER_SLOT]    = "Block trailer slot != block header slot",
+      [SIMPLE_ERROR_TRAILER_WORDS]   = "Block trailer #words != actual #words",
+      [SIMPLE_ERROR_BLOCK_EVENTS]    = "Events in block != block level",
+      [SIMPLE_ERROR_EVENT_HEADER]    = "Event header outside of a block",
+      [SIMPLE_ERROR_TOO_MANY_EVENTS] = "Too many events in block",
+      [SIMPLE_ERROR_TI_WORD_COUNT]   = "TI event word count past end of bank",
+      [SIMPLE_ERROR_SYNC_EVENT]      = "Slot event number != trigger event number",
+      [SIMPLE_ERROR_SYNC_BLOCK]      = "Slot block number != block number of most slots",
+      [SIMPLE_ERROR_BLOCK_GAP]       = "Slot block number does not follow its last block",
+      [SIMPLE_ERROR_DUPLICATE_ROC]   = "ROC bank found again in event, skipped",
+      [SIMPLE_ERROR_PAYLOAD_COUNT]   = "Word after the words counted by its header is not type defining"
+    };
+
+  if((code < 0) || (code >= SIMPLE_ERROR_NCODES))
+    return "Unknown error";
+
+  return errorString[code];
+}
+
+/**
+ * @ingroup Data Access
+ * @brief Print an error, as the scan does
+ *
+ * @param *err     Error, from simpleGetErrors()
+ */
+void
+simplePrintError(const simpleError *err)
+{
+  printf("simpleScan: ERROR: %s:", simpleErrorString(err->code));
+  if(err->index >= 0)
+    printf(" [%6d  0x%08x]", err->index, err->word);
+  if(err->rocID >= 0)
+    printf(" rocID %d", err->rocID);
+  if(err->bankID >= 0)
+    printf(" bank 0x%x", err->bankID);
+  if(err->slot >= 0)
+    printf(" slot %d", err->slot);
+  if(err->value != err->expected)
+    printf(" %d (expected %d)", err->value, err->expected);
+  printf(", event %llu\n", err->event);
+}
+
+/* Build the list of slots of each event of the block, from the index */
+static int
+simpleBuildEvents(simpleCtx *ctx)
+{
+  int iroc, ibank, islot, ievt, nevents, nslots = 0;
+  int count[SIMPLE_MAX_BLOCKLEVEL+1];
+  unsigned int *data = (unsigned int *)ctx->dataAddr;
+  bankDataInfo *bank;
+  slotDataInfo *slot;
+
+  if(data == NULL)
+    return ERROR;
+
+  nevents = simpleEventWord(ctx, data, 1) & 0xFF;	/* Block level of the CODA event */
+  memset(count, 0, sizeof(count));
+
+  for(iroc = 0; iroc < ctx->nRocs; iroc++)
+    {
+      rocBankInfo *roc = &ctx->rocBank[ctx->rocList[iroc]];
+      for(ibank = 0; ibank < roc->nbanks; ibank++)
+	{
+	  bank = roc->dataBank[ibank];
+	  if(ctx->lazy)
+	    simpleIndexBank(ctx, bank);
+	  if(!bank->indexed)
+	    continue;
+	  for(islot = 0; islot < SIMPLE_MAX_SLOTS; islot++)
+	    {
+	      if((bank->slotMask & (1u << islot)) == 0)
+		continue;
+	      slot = bank->slot[islot];
+	      if(slot->nevents > nevents)
+		nevents = slot->nevents;
+	      for(ievt = 0; ievt < slot->nevents; ievt++)
+		count[ievt]++;
+	      nslots += slot->nevents;
+	    }
+	}
+    }
+
+  if(nslots > ctx->eventSlotSize)
+    {
+      simpleEventSlot *es = (simpleEventSlot *)
+	realloc(ctx->eventSlot, nslots * sizeof(simpleEventSlot));
+      if(es == NULL)
+	{
+	  printf("%s: ERROR: Unable to allocate %d event slots\n", __func__, nslots);
+	  return ERROR;
+	}
+      ctx->eventSlot = es;
+      ctx->eventSlotSize = nslots;
+    }
+
+  ctx->eventStart[0] = 0;
+  for(ievt = 0; ievt < nevents; ievt++)
+    {
+      ctx->eventStart[ievt + 1] = ctx->eventStart[ievt] + count[ievt];
+      count[ievt] = ctx->eventStart[ievt];	/* Next free entry of each event */
+    }
+
+  for(iroc = 0; iroc < ctx->nRocs; iroc++)
+    {
+      rocBankInfo *roc = &ctx->rocBank[ctx->rocList[iroc]];
+      for(ibank = 0; ibank < roc->nbanks; ibank++)
+	{
+	  bank = roc->dataBank[ibank];
+	  if(!bank->indexed)
+	    continue;
+	  for(islot = 0; islot < SIMPLE_MAX_SLOTS; islot++)
+	    {
+	      if((bank->slotMask & (1u << islot)) == 0)
+		continue;
+	      slot = bank->slot[islot];
+	      for(ievt = 0; ievt < slot->nevents; ievt++)
+		{
+		  simpleEventSlot *es = &ctx->eventSlot[count[ievt]++];
+		  es->rocID  = bank->rocID;
+		  es->bankID = bank->bankID;
+		  es->slot   = islot;
+		  es->length = slot->evt[ievt].length;
+		  es->data   = SIMPLE_BANK_WORD(bank, slot->evt[ievt].index);
+		  if(SIMPLE_BANK_WRAPS(bank, slot->evt[ievt].index, es->length))
+		    es->data = NULL;
+		}
+	    }
+	}
+    }
+
+  ctx->nEvents = nevents;
+  ctx->eventsBuilt = 1;
+
+  return OK;
+}
+
+/**
+ * @ingroup Data Access
+ * @brief Return the number of events in the block indexed by the last scan
+ *
+ * @param ctx        Scan context
+ *
+ * @return Number of events if successful, otherwise ERROR
+ */
+int
+simpleCtxGetNevents(simpleCtx *ctx)
+{
+  if(!ctx->eventsBuilt && (simpleBuildEvents(ctx) != OK))
+    return ERROR;
+
+  return ctx->nEvents;
+}
+
+/**
+ * @ingroup Data Access
+ * @brief Return one event of the block: its trigger bank entries, and the
+ *    data of every slot (of every ROC and bank) for that event.
+ *    The list of slots is built once per scan, and points into the event.
+ *
+ * @param ctx        Scan context
+ * @param evt        Which event of the block
+ * @param *event     Where to store the event
+ *
+ * @return OK if successful, otherwise ERROR
+ */
+int
+simpleCtxGetEvent(simpleCtx *ctx, int evt, simpleEvent *event)
+{
+  unsigned long long *time;
+  unsigned short *type;
+  int len;
+
+  if(!ctx->eventsBuilt && (simpleBuildEvents(ctx) != OK))
+    return ERROR;
+
+  if((evt < 0) || (evt >= ctx->nEvents))
+    return ERROR;
+
+  event->evt       = evt;
+  event->evnum     = 0;
+  event->timestamp = 0;
+  event->type      = -1;
+
+  /* Time segment: First event number, then (if the tag says so) timestamps.
+     64 bit words may not be aligned. */
+  len = simpleCtxGetTriggerBankTimeSegment(ctx, &time);
+  if(len > 0)
+    {
+      memcpy(&event->evnum, &time[0], sizeof(unsigned long long));
+      event->evnum += evt;
+
+      if((ctx->trigBank.header.bf.tag & 0x1) && (1 + evt < len))
+	memcpy(&event->timestamp, &time[1 + evt], sizeof(unsigned long long));
+    }
+
+  len = simpleCtxGetTriggerBankTypeSegment(ctx, &type);
+  if(evt < len)
+    event->type = type[evt];
+
+  event->nslots = ctx->eventStart[evt + 1] - ctx->eventStart[evt];
+  event->slot   = &ctx->eventSlot[ctx->eventStart[evt]];
+
+  return OK;
+}
+
+/* Block numbers of a bank.  Banks come in the same order in each event, so
+   the entry after the last one is tried first */
+static simpleSyncBank *
+simpleSyncFindBank(simpleCtx *ctx, int rocID, int bankID)
+{
+  simpleSyncBank *sb;
+  int i;
+
+  if((ctx->syncBankNext < ctx->nSyncBank) &&
+     (ctx->syncBank[ctx->syncBankNext].rocID == rocID) &&
+     (ctx->syncBank[ctx->syncBankNext].bankID == bankID))
+    i = ctx->syncBankNext;
+  else
+    {
+      for(i = 0; i < ctx->nSyncBank; i++)
+	if((ctx->syncBank[i].rocID == rocID) && (ctx->syncBank[i].bankID == bankID))
+	  break;
+    }
+
+  if(i == ctx->nSyncBank)
+    {
+      if(ctx->nSyncBank == ctx->syncBankSize)
+	{
+	  int size = ctx->syncBankSize ? 2 * ctx->syncBankSize : 16;
+	  sb = (simpleSyncBank *) realloc(ctx->syncBank, size * sizeof(simpleSyncBank));
+	  if(sb == NULL)
+	    return NULL;
+	  ctx->syncBank = sb;
+	  ctx->syncBankSize = size;
+	}
+      sb = &ctx->syncBank[ctx->nSyncBank++];
+      memset(sb, 0, sizeof(simpleSyncBank));
+      sb->rocID  = rocID;
+      sb->bankID = bankID;
+    }
+
+  ctx->syncBankNext = i + 1;
+
+  return &ctx->syncBank[i];
+}
+
+/* Word at index of a data bank, in native byte order */
+static inline unsigned int
+simpleSyncWord(const bankDataInfo *bank, int swap, int index)
+{
+  unsigned int word = *SIMPLE_BANK_WORD(bank, index);
+
+  return swap ? bswap_32(word) : word;
+}
+
+/* Event number of an event of a slot: the event header's for JLab modules,
+   the word after the event header for the TI, TS and TD.
+   ~expected (sure to differ) if there is none. */
+static inline unsigned int
+simpleSyncEvnum(const bankDataInfo *bank, int swap, int ti,
+		const simpleEventData *evt, unsigned int expected)
+{
+  if(!ti)
+    return simpleSyncWord(bank, swap, evt->index);
+
+  return (evt->length > 1) ? simpleSyncWord(bank, swap, evt->index + 1) : ~expected;
+}
+
+/* Boyer-Moore majority vote: value once all have been added, if most agree */
+#define SIMPLE_VOTE(value, votes, x)		\
+  {						\
+    if((votes) == 0)				\
+      {						\
+	(value) = (x);				\
+	(votes) = 1;				\
+      }						\
+    else if((value) == (x))			\
+      (votes)++;				\
+    else					\
+      (votes)--;				\
+  }
+
+#define SIMPLE_IS_TI(modID)  (((modID) == MODID_TI) || ((modID) == MODID_TS) || \
+			      ((modID) == MODID_TD))
+
+/**
+ * @ingroup Data Access
+ * @brief Check that every ROC and slot of the scanned block has the same
+ *    triggers: the event number of each slot event against the trigger bank,
+ *    the block number of each slot against the other slots, and against
+ *    the slot's block number in the block checked before.
+ *    A slot that fails is recorded as an error (SIMPLE_ERROR_SYNC_EVENT,
+ *    SIMPLE_ERROR_SYNC_BLOCK, SIMPLE_ERROR_BLOCK_GAP), and counted in
+ *    simpleCtxGetSyncStats().  Call it after each scan.
+ *
+ *    Event numbers are compared on the 22 bits of the JLab event header
+ *    (32 for the TI).  Without a time segment in the trigger bank, they are
+ *    compared against the first event number of most slots.
+ *
+ * @param ctx        Scan context
+ *
+ * @return Number of slots out of sync, otherwise ERROR
+ */
+int
+simpleCtxCheckSync(simpleCtx *ctx)
+{
+  const simpleKernel *kernel = simpleKernelGet();
+  unsigned int *data = (unsigned int *)ctx->dataAddr;
+  unsigned int evnum[SIMPLE_MAX_BLOCKLEVEL + 1];
+  unsigned int first = 0, blockNumber = 0, mask, next;
+  unsigned long long trigFirst, bad;
+  int iroc, ibank, islot, ievt, n, nw, swap, ti, hasTrig, flagged, nflagged = 0;
+  int blockVotes = 0, evnumVotes = 0;
+  bankDataInfo *bank;
+  slotDataInfo *slot;
+  simpleSyncBank *sb;
+  block_header_t bheader;
+
+  if(data == NULL)
+    {
+      printf("%s: ERROR: No event scanned\n", __func__);
+      return ERROR;
+    }
+
+  /* Trigger event number of the first event */
+  hasTrig = (ctx->trigBank.segTime.header.bf.num >= 2);
+  if(hasTrig)
+    {
+      unsigned int w[2];
+
+      /* Either word may be after the end of a ring */
+      w[0] = simpleEventWord(ctx, data, ctx->trigBank.segTime.index);
+      w[1] = simpleEventWord(ctx, data, ctx->trigBank.segTime.index + 1);
+      memcpy(&trigFirst, w, sizeof(trigFirst));
+      first = (unsigned int)trigFirst;
+    }
+
+  /* Block number of most slots (and first event number, without a trigger) */
+  for(iroc = 0; iroc < ctx->nRocs; iroc++)
+    {
+      rocBankInfo *roc = &ctx->rocBank[ctx->rocList[iroc]];
+      for(ibank = 0; ibank < roc->nbanks; ibank++)
+	{
+	  bank = roc->dataBank[ibank];
+	  if(ctx->lazy)
+	    simpleIndexBank(ctx, bank);
+	  if(!bank->indexed)
+	    continue;
+	  swap = bank->config && bank->config->endian && !bank->swapped;
+
+	  for(islot = 0; islot < SIMPLE_MAX_SLOTS; islot++)
+	    {
+	      if((bank->slotMask & (1u << islot)) == 0)
+		continue;
+	      slot = bank->slot[islot];
+	      if(slot->blkIndex < bank->bank.index)
+		continue;
+
+	      bheader.raw = simpleSyncWord(bank, swap, slot->blkIndex);
+	      SIMPLE_VOTE(blockNumber, blockVotes, bheader.bf.event_block_number);
+
+	      if(!hasTrig && (slot->nevents > 0))
+		{
+		  ti = SIMPLE_IS_TI(bheader.bf.module_ID);
+		  next = simpleSyncEvnum(bank, swap, ti, &slot->evt[0], 0) &
+		    EVENT_HEADER_EVT_NUM_MASK;
+		  SIMPLE_VOTE(first, evnumVotes, next);
+		}
+	    }
+	}
+    }
+
+  /* Each slot against them */
+  for(iroc = 0; iroc < ctx->nRocs; iroc++)
+    {
+      rocBankInfo *roc = &ctx->rocBank[ctx->rocList[iroc]];
+      for(ibank = 0; ibank < roc->nbanks; ibank++)
+	{
+	  bank = roc->dataBank[ibank];
+	  if(!bank->indexed)
+	    continue;
+	  swap = bank->config && bank->config->endian && !bank->swapped;
+	  sb = simpleSyncFindBank(ctx, bank->rocID, bank->bankID);
+
+	  for(islot = 0; islot < SIMPLE_MAX_SLOTS; islot++)
+	    {
+	      if((bank->slotMask & (1u << islot)) == 0)
+		continue;
+	      slot = bank->slot[islot];
+	      if(slot->blkIndex < bank->bank.index)
+		continue;
+
+	      flagged = 0;
+	      bheader.raw = simpleSyncWord(bank, swap, slot->blkIndex);
+	      ti = SIMPLE_IS_TI(bheader.bf.module_ID);
+	      mask = (ti && hasTrig) ? 0xFFFFFFFF : EVENT_HEADER_EVT_NUM_MASK;
+
+	      /* Gather the event numbers, then compare with the kernel */
+	      n = slot->nevents;
+	      for(ievt = 0; ievt < n; ievt++)
+		evnum[ievt] = simpleSyncEvnum(bank, swap, ti, &slot->evt[ievt], first + ievt);
+
+	      for(ievt = 0; ievt < n; ievt += SIMPLE_KERNEL_WORDS)
+		{
+		  nw = (n - ievt < SIMPLE_KERNEL_WORDS) ? n - ievt : SIMPLE_KERNEL_WORDS;
+		  bad = (*kernel->sequenceMask)(&evnum[ievt], nw, first + ievt, mask);
+		  if(bad == 0)
+		    continue;
+
+		  ctx->sync.nevnumErrors += __builtin_popcountll(bad);
+		  if(!flagged)
+		    {
+		      int ibad = ievt + __builtin_ctzll(bad);
+		      simpleCtxError(ctx, SIMPLE_ERROR_SYNC_EVENT, slot->evt[ibad].index,
+				     simpleSyncWord(bank, swap, slot->evt[ibad].index),
+				     bank->rocID, bank->bankID, islot,
+				     evnum[ibad] & mask, (first + ibad) & mask);
+		      flagged = 1;
+		    }
+		}
+	      ctx->sync.nevents += n;
+
+	      if(bheader.bf.event_block_number != blockNumber)
+		{
+		  ctx->sync.nblockNumErrors++;
+		  simpleCtxError(ctx, SIMPLE_ERROR_SYNC_BLOCK, slot->blkIndex, bheader.raw,
+				 bank->rocID, bank->bankID, islot,
+				 bheader.bf.event_block_number, blockNumber);
+		  flagged = 1;
+		}
+
+	      if(sb)
+		{
+		  next = (sb->blockNumber[islot] + 1) & (BLOCK_HEADER_BLK_NUM_MASK >> 8);
+		  if((sb->slotMask & (1u << islot)) && (bheader.bf.event_block_number != next))
+		    {
+		      ctx->sync.nblockGaps++;
+		      simpleCtxError(ctx, SIMPLE_ERROR_BLOCK_GAP, slot->blkIndex, bheader.raw,
+				     bank->rocID, bank->bankID, islot,
+				     bheader.bf.event_block_number, next);
+		      flagged = 1;
+		    }
+		  sb->slotMask |= (1u << islot);
+		  sb->blockNumber[islot] = bheader.bf.event_block_number;
+		}
+
+	      ctx->sync.nslots++;
+	      if(flagged)
+		{
+		  ctx->sync.ndesyncSlots++;
+		  nflagged++;
+		}
+	    }
+	}
+    }
+
+  ctx->sync.nblocks++;
+  if(nflagged)
+    ctx->sync.ndesyncBlocks++;
+
+  return nflagged;
+}
+
+/**
+ * @ingroup Data Access
+ * @brief Return the running counts of simpleCtxCheckSync()
  *
- * @return Length of the buffer if successful, otherwise ERROR
+ * @param ctx      Scan context
+ * @param *stats   Where to store them
+ *
+ * @return OK
+ */
+int
+simpleCtxGetSyncStats(simpleCtx *ctx, simpleSyncStats *stats)
+{
+  *stats = ctx->sync;
+
+  return OK;
+}
+
+/**
+ * @ingroup Data Access
+ * @brief Clear the counts of simpleCtxGetSyncStats(), and the block number
+ *    of each slot (the next block checked starts over, without gaps)
+ *
+ * @param ctx      Scan context
  */
+void
+simpleCtxResetSync(simpleCtx *ctx)
+{
+  memset(&ctx->sync, 0, sizeof(simpleSyncStats));
+  ctx->nSyncBank = 0;
+  ctx->syncBankNext = 0;
+}
+
+/* Append the slot events indexed from event ievent of a batch.
+   ERROR if they do not all fit, with nothing appended */
+static int
+simpleBatchRecords(simpleCtx *ctx, int ievent, simpleBatch *out)
+{
+  int iroc, ibank, islot, ievt, nrecords = out->nrecords;
+  bankDataInfo *bank;
+  slotDataInfo *slot;
+  simpleBatchRecord *rec;
 
+  for(iroc = 0; iroc < ctx->nRocs; iroc++)
+    {
+      rocBankInfo *roc = &ctx->rocBank[ctx->rocList[iroc]];
+      for(ibank = 0; ibank < roc->nbanks; ibank++)
+	{
+	  bank = roc->dataBank[ibank];
+	  if(ctx->lazy)
+	    simpleIndexBank(ctx, bank);
+	  if(!bank->indexed)
+	    continue;
+	  for(islot = 0; islot < SIMPLE_MAX_SLOTS; islot++)
+	    {
+	      if((bank->slotMask & (1u << islot)) == 0)
+		continue;
+	      slot = bank->slot[islot];
+
+	      if(nrecords + slot->nevents > out->maxRecords)
+		return ERROR;
+
+	      for(ievt = 0; ievt < slot->nevents; ievt++)
+		{
+		  rec = &out->record[nrecords++];
+		  rec->event  = ievent;
+		  rec->rocID  = bank->rocID;
+		  rec->bankID = bank->bankID;
+		  rec->slot   = islot;
+		  rec->evt    = ievt;
+		  rec->offset = slot->evt[ievt].index;
+		  rec->length = slot->evt[ievt].length;
+		}
+	    }
+	}
+    }
+
+  out->nrecords = nrecords;
+
+  return OK;
+}
+
+/**
+ * @ingroup Unblock
+ * @brief Index an array of CODA events, into one caller-owned arena.
+ *
+ *    Each event is scanned with the context by simpleCtxScan(), one at a
+ *    time, and the data of each slot for each event of its block is appended
+ *    to out->record[]: event by event, then bank by bank as they are in
+ *    the event, then by slot and by event of the block.  Offsets are
+ *    words from the start of the CODA event (events[event]).  Data of
+ *    banks swapped into the swap buffer is still in its original byte
+ *    order there.
+ *
+ *    out->eventStart[], if not NULL, gets the first record of each event
+ *    (n+1 entries).  out->status[], if not NULL, gets the scan status of
+ *    each event (n entries).  Events that fail to scan have no records.
+ *    An event with more records than out->maxRecords has none either,
+ *    and the status SIMPLE_BATCH_TOO_BIG, as no batch could hold them.
+ *
+ *    The context keeps the index of the last event scanned.
+ *
+ * @param ctx      Scan context
+ * @param events   Address of each CODA event
+ * @param lengths  Words in the buffer of each event
+ * @param n        Number of events
+ * @param out      Record arena, with record and maxRecords set
+ *
+ * @return Number of events done.  Less than n if the arena filled up,
+ *         so the next batch may start there.  ERROR for invalid arguments.
+ */
 int
-simpleGetTriggerBankRocSegment(int rocID, unsigned int **buffer)
+simpleCtxScanBatch(simpleCtx *ctx, volatile unsigned int **events, const int *lengths,
+		   int n, simpleBatch *out)
 {
-  int len = 0;
-  unsigned long addr = 0;
+  int ievent, status, start;
 
-  if(trigBank.segRoc[rocID].header.bf.tag != rocID)
+  if((events == NULL) || (lengths == NULL) || (n < 0) ||
+     (out == NULL) || ((out->record == NULL) && (out->maxRecords > 0)))
     {
-      return -1;
+      printf("%s: ERROR: Invalid arguments\n", __func__);
+      return ERROR;
     }
 
-  addr = (unsigned long)((unsigned int *)dataAddr + trigBank.segRoc[rocID].index);
-  *buffer = (unsigned int *) addr;
+  out->nrecords = 0;
 
-  len = trigBank.segRoc[rocID].header.bf.num;
+  for(ievent = 0; ievent < n; ievent++)
+    {
+      start = out->nrecords;
+      if(out->eventStart)
+	out->eventStart[ievent] = start;
 
-  return len;
+      status = simpleCtxScan(ctx, events[ievent], lengths[ievent]);
+      if((status == OK) && (simpleBatchRecords(ctx, ievent, out) != OK))
+	{
+	  if(start > 0)
+	    break;		/* Arena is full, the next batch starts here */
+
+	  /* Too big for an empty arena: skip it, or no batch gets past it */
+	  status = SIMPLE_BATCH_TOO_BIG;
+	}
+
+      if(out->status)
+	out->status[ievent] = status;
+    }
+
+  if(out->eventStart)
+    out->eventStart[ievent] = out->nrecords;
+
+  return ievent;
+}
+
+/* Routines using the default context.  Only one event may be indexed
+   at a time with these.  Use a context from simpleCtxCreate() to scan in
+   more than one thread. */
+
+int
+simpleScan(volatile unsigned int *data, int nwords)
+{
+  return simpleCtxScan(&simpleDefaultCtx, data, nwords);
+}
+
+int
+simpleScanCodaEvent(volatile unsigned int *data)
+{
+  return simpleCtxScanCodaEvent(&simpleDefaultCtx, data);
+}
+
+int
+simpleScanBank(volatile unsigned int *data, int rocID, int bankNumber)
+{
+  return simpleCtxScanBank(&simpleDefaultCtx, data, rocID, bankNumber);
+}
+
+int
+simpleStreamStart(volatile unsigned int *data, int bufferWords)
+{
+  return simpleCtxStreamStart(&simpleDefaultCtx, data, bufferWords);
+}
+
+int
+simpleStreamFeed(int nwords, int *nrocs)
+{
+  return simpleCtxStreamFeed(&simpleDefaultCtx, nwords, nrocs);
+}
+
+int
+simpleScanRing(volatile unsigned int *base, int size, int start)
+{
+  return simpleCtxScanRing(&simpleDefaultCtx, base, size, start);
+}
+
+int
+simpleGetNevents()
+{
+  return simpleCtxGetNevents(&simpleDefaultCtx);
+}
+
+int
+simpleGetEvent(int evt, simpleEvent *event)
+{
+  return simpleCtxGetEvent(&simpleDefaultCtx, evt, event);
+}
+
+int
+simpleCheckSync()
+{
+  return simpleCtxCheckSync(&simpleDefaultCtx);
+}
+
+int
+simpleGetSyncStats(simpleSyncStats *stats)
+{
+  return simpleCtxGetSyncStats(&simpleDefaultCtx, stats);
+}
+
+void
+simpleResetSync()
+{
+  simpleCtxResetSync(&simpleDefaultCtx);
+}
+
+int
+simpleGetRocList(int *rocList)
+{
+  return simpleCtxGetRocList(&simpleDefaultCtx, rocList);
+}
+
+int
+simpleGetBankList(int rocID, int *bankList)
+{
+  return simpleCtxGetBankList(&simpleDefaultCtx, rocID, bankList);
+}
+
+int
+simpleGetRocBanks(int rocID, int bankID, int *bankList)
+{
+  return simpleCtxGetRocBanks(&simpleDefaultCtx, rocID, bankID, bankList);
+}
+
+int
+simpleGetRocSlotmask(int rocID, int bankID, unsigned int *slotmask)
+{
+  return simpleCtxGetRocSlotmask(&simpleDefaultCtx, rocID, bankID, slotmask);
+}
+
+int
+simpleGetRocBankData(int rocID, int bankID, unsigned int **buffer)
+{
+  return simpleCtxGetRocBankData(&simpleDefaultCtx, rocID, bankID, buffer);
+}
+
+int
+simpleGetRocBankSpan(int rocID, int bankID, simpleSpan *span)
+{
+  return simpleCtxGetRocBankSpan(&simpleDefaultCtx, rocID, bankID, span);
+}
+
+int
+simpleGetRocEventView(int rocID, int bankID, const simpleEventData **view, int *nslots)
+{
+  return simpleCtxGetRocEventView(&simpleDefaultCtx, rocID, bankID, view, nslots);
+}
+
+int
+simpleGetRocBlockLevel(int rocID, int bankID, int *blockLevel)
+{
+  return simpleCtxGetRocBlockLevel(&simpleDefaultCtx, rocID, bankID, blockLevel);
+}
+
+int
+simpleGetRocBankSwap(int rocID, int bankID, int *swapMode)
+{
+  return simpleCtxGetRocBankSwap(&simpleDefaultCtx, rocID, bankID, swapMode);
+}
+
+int
+simpleGetSlotBlockHeader(int rocID, int bankID, int slot, unsigned int *header)
+{
+  return simpleCtxGetSlotBlockHeader(&simpleDefaultCtx, rocID, bankID, slot, header);
+}
+
+int
+simpleGetSlotEventHeader(int rocID, int bankID, int slot, int evt, unsigned int *header)
+{
+  return simpleCtxGetSlotEventHeader(&simpleDefaultCtx, rocID, bankID, slot, evt, header);
+}
+
+int
+simpleGetSlotEventData(int rocID, int bankID, int slot, int evt, unsigned int **buffer)
+{
+  return simpleCtxGetSlotEventData(&simpleDefaultCtx, rocID, bankID, slot, evt, buffer);
+}
+
+int
+simpleGetSlotEventSpan(int rocID, int bankID, int slot, int evt, simpleSpan *span)
+{
+  return simpleCtxGetSlotEventSpan(&simpleDefaultCtx, rocID, bankID, slot, evt, span);
+}
+
+int
+simpleGetSlotBlockTrailer(int rocID, int bankID, int slot, unsigned int *trailer)
+{
+  return simpleCtxGetSlotBlockTrailer(&simpleDefaultCtx, rocID, bankID, slot, trailer);
+}
+
+int
+simpleGetTriggerBankTimeSegment(unsigned long long **buffer)
+{
+  return simpleCtxGetTriggerBankTimeSegment(&simpleDefaultCtx, buffer);
+}
+
+int
+simpleGetTriggerBankTypeSegment(unsigned short **buffer)
+{
+  return simpleCtxGetTriggerBankTypeSegment(&simpleDefaultCtx, buffer);
+}
+
+int
+simpleGetTriggerBankRocSegment(int rocID, unsigned int **buffer)
+{
+  return simpleCtxGetTriggerBankRocSegment(&simpleDefaultCtx, rocID, buffer);
+}
+
+int
+simpleGetTriggerColumns(simpleTriggerColumns *cols, int offset)
+{
+  return simpleCtxGetTriggerColumns(&simpleDefaultCtx, cols, offset);
+}
+
+int
+simpleGetSkipCounts(simpleSkipCount *list, int max)
+{
+  return simpleCtxGetSkipCounts(&simpleDefaultCtx, list, max);
+}
+
+void
+simpleResetSkipCounts()
+{
+  simpleCtxResetSkipCounts(&simpleDefaultCtx);
+}
+
+int
+simpleGetStats(simpleStats *stats)
+{
+  return simpleCtxGetStats(&simpleDefaultCtx, stats);
+}
+
+int
+simpleGetBankStats(simpleBankStats *list, int max)
+{
+  return simpleCtxGetBankStats(&simpleDefaultCtx, list, max);
+}
+
+void
+simpleResetStats()
+{
+  simpleCtxResetStats(&simpleDefaultCtx);
+}
+
+int
+simpleGetTrace(simpleTraceRecord *list, int max)
+{
+  return simpleCtxGetTrace(&simpleDefaultCtx, list, max);
+}
+
+int
+simpleGetErrors(simpleError *list, int max)
+{
+  return simpleCtxGetErrors(&simpleDefaultCtx, list, max);
+}
+
+int
+simpleGetErrorCounts(unsigned long long *counts, int max)
+{
+  return simpleCtxGetErrorCounts(&simpleDefaultCtx, counts, max);
+}
+
+void
+simpleResetErrors()
+{
+  simpleCtxResetErrors(&simpleDefaultCtx);
+}
+
+int
+simpleScanBatch(volatile unsigned int **events, const int *lengths, int n, simpleBatch *out)
+{
+  return simpleCtxScanBatch(&simpleDefaultCtx, events, lengths, n, out);
 }
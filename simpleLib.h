@@ -200,6 +200,28 @@ typedef enum simpleEndianType
   } simpleEndian;
 
 
+typedef enum simpleSwapType
+  {
+    SIMPLE_SWAP_NONE    = 0,	/* Swap words as they are scanned */
+    SIMPLE_SWAP_INPLACE = 1,	/* Swap the whole bank, in the event buffer */
+    SIMPLE_SWAP_BUFFER  = 2	/* Swap the whole bank, into the context's swap buffer */
+  } simpleSwap;
+
+typedef enum simpleValidateType
+  {
+    SIMPLE_VALIDATE_OFF  = 0,	/* Only keep inside the buffer and bank lengths */
+    SIMPLE_VALIDATE_FAST = 1,	/* And check that banks and segments fill their parents */
+    SIMPLE_VALIDATE_FULL = 2	/* And check block trailers, slots and block levels */
+  } simpleValidate;
+
+typedef enum simpleKernelType
+  {
+    SIMPLE_KERNEL_AUTO   = 0,
+    SIMPLE_KERNEL_SCALAR = 1,
+    SIMPLE_KERNEL_SSE2   = 2,
+    SIMPLE_KERNEL_AVX2   = 3
+  } simpleKernelType;
+
 typedef enum simpleDebugType
   {
     SIMPLE_SHOW_BLOCK_HEADER     = (1<<0),
@@ -217,6 +239,86 @@ typedef enum simpleDebugType
     SIMPLE_SHOW_SCALER_HEADER    = (1<<12)
   } simpleDebug;
 
+/* What a trace record is, and the simpleDebug bit that shows it */
+typedef enum simpleTraceKindType
+  {
+    SIMPLE_TRACE_EVENT = 0,		/* CODA event header, arg = length */
+    SIMPLE_TRACE_TRIGGER_BANK,		/* SIMPLE_SHOW_BANK_FOUND, arg = length */
+    SIMPLE_TRACE_SEGMENT,		/* SIMPLE_SHOW_SEGMENT_FOUND */
+    SIMPLE_TRACE_ROC_BANK,		/* SIMPLE_SHOW_BANK_FOUND, arg = length */
+    SIMPLE_TRACE_DATA_BANK,		/* SIMPLE_SHOW_BANK_FOUND, arg = length */
+    SIMPLE_TRACE_FLAT_BANK,		/* SIMPLE_SHOW_BANK_FOUND, module header, arg = length */
+    SIMPLE_TRACE_IGNORED_BANK,		/* SIMPLE_SHOW_IGNORED_BANKS, arg = length */
+    SIMPLE_TRACE_BLOCK_HEADER,		/* SIMPLE_SHOW_BLOCK_HEADER */
+    SIMPLE_TRACE_BLOCK_TRAILER,		/* SIMPLE_SHOW_BLOCK_TRAILER */
+    SIMPLE_TRACE_EVENT_HEADER,		/* SIMPLE_SHOW_EVENT_HEADER */
+    SIMPLE_TRACE_TI_EVENT,		/* SIMPLE_SHOW_EVENT_HEADER, TI event word count */
+    SIMPLE_TRACE_SCALER_HEADER,		/* SIMPLE_SHOW_SCALER_HEADER */
+    SIMPLE_TRACE_OTHER,			/* SIMPLE_SHOW_OTHER */
+    SIMPLE_TRACE_NKINDS
+  } simpleTraceKind;
+
+/* One word seen by the scan, from simpleGetTrace() */
+typedef struct TraceRecordStruct
+{
+  unsigned int index;		/* Of the word, from the start of the event */
+  unsigned int word;		/* As read (swapped if the bank is) */
+  unsigned int arg;		/* Depends on kind, 0 if nothing */
+  unsigned int kind;		/* simpleTraceKind */
+} simpleTraceRecord;
+
+/* Ring buffer of trace records, one per context */
+typedef struct SimpleTraceStruct simpleTrace;
+
+/* Errors found by the scan, from simpleGetErrors() */
+typedef enum simpleErrorCodeType
+  {
+    SIMPLE_ERROR_NONE = 0,
+    SIMPLE_ERROR_EVENT_LENGTH,		/* Event length does not fit the buffer */
+    SIMPLE_ERROR_BANK_TYPE,		/* Unexpected event, trigger or ROC bank type */
+    SIMPLE_ERROR_TRIGGER_LENGTH,	/* Trigger bank past end of event */
+    SIMPLE_ERROR_SEGMENT_LENGTH,	/* Segment past end of trigger bank */
+    SIMPLE_ERROR_SEGMENT_TYPE,		/* Unexpected segment in trigger bank */
+    SIMPLE_ERROR_TRIGGER_NROCS,		/* ROC segments != trigger bank nrocs */
+    SIMPLE_ERROR_ROC_ID,		/* rocID >= SIMPLE_MAX_ROCS */
+    SIMPLE_ERROR_ROC_LENGTH,		/* ROC bank past end of event */
+    SIMPLE_ERROR_BANK_LENGTH,		/* Data bank past end of ROC bank */
+    SIMPLE_ERROR_ROC_END,		/* Data banks do not end at end of ROC bank */
+    SIMPLE_ERROR_EVENT_END,		/* ROC banks do not end at end of event */
+    SIMPLE_ERROR_TOO_MANY_BANKS,	/* More than SIMPLE_MAX_BANKS in a ROC */
+    SIMPLE_ERROR_DUPLICATE_BANK,	/* Bank found again in a ROC bank of uint32s */
+    SIMPLE_ERROR_ALLOC,			/* Unable to allocate the index */
+    SIMPLE_ERROR_BLOCK_LEVEL,		/* Slot block level != first slot's */
+    SIMPLE_ERROR_TRAILER_SLOT,		/* Block trailer slot != block header slot */
+    SIMPLE_ERROR_TRAILER_WORDS,		/* Block trailer word count != words in block */
+    SIMPLE_ERROR_BLOCK_EVENTS,		/* Events in block != block level */
+    SIMPLE_ERROR_EVENT_HEADER,		/* Event header outside of a block */
+    SIMPLE_ERROR_TOO_MANY_EVENTS,	/* More than SIMPLE_MAX_BLOCKLEVEL+1 events */
+    SIMPLE_ERROR_TI_WORD_COUNT,		/* TI event past end of bank */
+    SIMPLE_ERROR_SYNC_EVENT,		/* Slot event number != trigger event number */
+    SIMPLE_ERROR_SYNC_BLOCK,		/* Slot block number != most slots' block number */
+    SIMPLE_ERROR_BLOCK_GAP,		/* Slot block number does not follow its last one */
+    SIMPLE_ERROR_DUPLICATE_ROC,		/* ROC bank found again in the event */
+    SIMPLE_ERROR_PAYLOAD_COUNT,		/* Word after the words counted by a header not type defining */
+    SIMPLE_ERROR_NCODES
+  } simpleErrorCode;
+
+#define SIMPLE_MAX_ERRORS       64	/* Errors kept by each context */
+#define SIMPLE_ERROR_PRINT_RATE 10	/* Default errors printed per second */
+
+typedef struct ErrorStruct
+{
+  int          code;		/* simpleErrorCode */
+  int          index;		/* Of the word, from the start of the event. -1 if none */
+  unsigned int word;		/* The word, 0 if none */
+  int          rocID;		/* -1 if none */
+  int          bankID;		/* -1 if none */
+  int          slot;		/* -1 if none */
+  int          value;		/* What was found */
+  int          expected;	/* What was expected, or the limit */
+  unsigned long long event;	/* Scan of the context it was found in, from 1 */
+} simpleError;
+
 typedef struct
 {
   unsigned int num:8;
@@ -266,11 +368,102 @@ typedef struct BankConfigStruct
   int rocID;
   int    endian;
   int    isBlocked;
+  int    swapMode;
   unsigned int module_header;
   unsigned int header_mask;
   void  *firstPassRoutine;
 } simpleBankConfig;
 
+/* Index (from the start of the event) and length of one event's data */
+typedef struct EventDataStruct
+{
+  unsigned int index;
+  unsigned int length;
+} simpleEventData;
+
+typedef struct SlotDataStruct
+{
+  int blkIndex;
+  int blkTrailerIndex;
+  int nevents;
+  int maxEvents;		/* Room in evt, sized by the block level */
+  simpleEventData *evt;		/* Events of the block, packed */
+} slotDataInfo;
+
+/* What the scan of one bank found, kept for the stats (SIMPLE_STATS builds) */
+typedef struct ScanCountStruct
+{
+  unsigned int nblockHeaders;
+  unsigned int neventHeaders;
+  unsigned int nblockTrailers;
+  unsigned int nscalerWords;
+  unsigned int nblockErrors;	/* Block trailer and block level mismatches */
+  int          status;		/* Returned by the scan routine */
+  unsigned long long nsec;	/* Time indexing the bank, if stats are on */
+} simpleScanCount;
+
+#ifdef SIMPLE_STATS
+#define SIMPLE_COUNT(scan, field, n)  ((scan)->count->field += (n))
+#else
+#define SIMPLE_COUNT(scan, field, n)  do { } while(0)
+#endif
+
+typedef struct BankDataStruct
+{
+  int rocID;
+  int bankID;
+  int indexed;
+  codaBankInfo bank;
+  const simpleBankConfig *config;	/* NULL if not configured */
+  int swapMode;			/* How this bank is byte swapped */
+  int swapped;
+  unsigned int *bankBase;	/* First word of the bank's data */
+  int wrap;			/* Words at bankBase.  Less than the length if the */
+  unsigned int *wrapBase;	/* data wraps around a ring, the rest are here */
+  int blkLevel;
+  int evtCounter;
+  unsigned int slotMask;
+  slotDataInfo *slot[SIMPLE_MAX_SLOTS];
+  simpleEventData *evtView;	/* Event major copy of the slots' events, or NULL */
+  int viewSlots;
+  int viewEvents;
+  simpleScanCount count;	/* Of the last scan of this bank */
+} bankDataInfo;
+
+/* What a bank scan routine (firstPassRoutine) is handed */
+typedef struct BankScanStruct
+{
+  bankDataInfo *bank;		/* Bank to index */
+  const unsigned int *data;	/* First word of its data (bank->bankBase) */
+  int nwords;			/* Number of words of data */
+  int index;			/* Index of data[0] from the start of the event */
+  int endian;			/* data is big endian, swap each word read */
+  int debugMask;
+  void *pool;			/* For simpleScanAddSlot() */
+  int validate;			/* SIMPLE_VALIDATE_OFF, _FAST or _FULL */
+  simpleScanCount *count;	/* For SIMPLE_COUNT() */
+  simpleTrace *trace;		/* For SIMPLE_TRACE_WORD(), NULL if off */
+  struct SimpleCtxStruct *ctx;	/* For simpleScanError() */
+  int wrap;			/* Words at data.  If less than nwords, the data */
+  const unsigned int *wrapData;	/* wraps around a ring, and the rest are here */
+} simpleBankScan;
+
+/* Record a word in the trace, and show it if the debug mask says to.
+   Only in SIMPLE_TRACE builds, otherwise nothing is left of it */
+#ifdef SIMPLE_TRACE
+#define SIMPLE_TRACE_WORD(src, kind, index, word, arg)			\
+  do {									\
+    if((src)->trace || (src)->debugMask)				\
+      simpleTraceWord((src)->trace, (src)->debugMask, kind, index, word, arg); \
+  } while(0)
+#else
+#define SIMPLE_TRACE_WORD(src, kind, index, word, arg)  do { } while(0)
+#endif
+
+/* Indices recorded in the slot data are from the start of the event (index + i).
+   Return OK if successful, otherwise ERROR */
+typedef int (*simpleScanRoutine)(simpleBankScan *scan);
+
 typedef struct RocBankStruct
 {
   int length;
@@ -278,7 +471,8 @@ typedef struct RocBankStruct
   int index;
   int rocID;
   int nbanks;
-  codaBankInfo dataBank[SIMPLE_MAX_BANKS];
+  int found;			/* Found in the last event */
+  bankDataInfo *dataBank[SIMPLE_MAX_BANKS];
 } rocBankInfo;
 
 typedef struct TriggerBankStruct
@@ -292,18 +486,185 @@ typedef struct TriggerBankStruct
   codaSegmentInfo segRoc[SIMPLE_MAX_ROCS];
 } trigBankInfo;
 
-typedef struct BankDataStruct
+#define SIMPLE_CONFIG_LOOKUP_BITS  10
+#define SIMPLE_CONFIG_LOOKUP_SIZE  (1 << SIMPLE_CONFIG_LOOKUP_BITS)
+
+typedef struct SimpleConfigStruct
+{
+  simpleBankConfig uBank[SIMPLE_MAX_BANKS];
+  int              nubanks;
+  int              ignoreUndefinedBanks;
+  /* uBank index + 1 of each configured (rocID, tag), by hash.  0 if empty */
+  unsigned short   lookup[SIMPLE_CONFIG_LOOKUP_SIZE];
+} simpleConfig;
+
+/* One slot's data for one event of the block */
+typedef struct EventSlotStruct
+{
+  int           rocID;
+  int           bankID;
+  int           slot;
+  int           length;
+  unsigned int *data;		/* NULL if it wraps around a ring (simpleGetSlotEventSpan()) */
+} simpleEventSlot;
+
+/* Data that may wrap around the end of a ring (simpleScanRing()): length[0]
+   words at data[0], then length[1] at data[1].  length[1] is 0 if it does not */
+typedef struct SpanStruct
+{
+  unsigned int *data[2];
+  int           length[2];
+} simpleSpan;
+
+/* One event of the block, from simpleGetEvent() */
+typedef struct EventStruct
+{
+  int                    evt;	/* Event in the block */
+  unsigned long long     evnum;	/* Trigger event number, 0 if no time segment */
+  unsigned long long     timestamp;	/* 0 if none */
+  int                    type;	/* Event type, -1 if none */
+  int                    nslots;
+  const simpleEventSlot *slot;	/* Valid until the next scan */
+} simpleEvent;
+
+/* Running counts of simpleCheckSync(), since the context was created
+   (or simpleResetSync()) */
+typedef struct SyncStatsStruct
+{
+  unsigned long long nblocks;		/* CODA events (blocks) checked */
+  unsigned long long nslots;		/* Slot blocks checked */
+  unsigned long long nevents;		/* Slot event numbers compared */
+  unsigned long long nevnumErrors;	/* Slot events with the wrong event number */
+  unsigned long long nblockNumErrors;	/* Slot blocks with the wrong block number */
+  unsigned long long nblockGaps;	/* Slot blocks not numbered after the slot's last */
+  unsigned long long ndesyncSlots;	/* Slot blocks with any of these */
+  unsigned long long ndesyncBlocks;	/* CODA events with any of these */
+} simpleSyncStats;
+
+/* Trigger bank columns (structure of arrays), one entry per event,
+   filled by simpleGetTriggerColumns() and simpleFileReadTriggerColumns().
+   Any of the arrays may be NULL, to skip that column. */
+typedef struct TriggerColumnsStruct
+{
+  unsigned long long *evnum;	/* Trigger event number, 0 if no time segment */
+  unsigned long long *timestamp;	/* 0 if none */
+  unsigned short     *type;	/* Event type, 0xFFFF if none */
+  int                 max;	/* Room in each array, in events */
+  int                 timestampBits;	/* Keep the low 48 (TI) bits, or 64 (0 is 64) */
+} simpleTriggerColumns;
+
+#define SIMPLE_TRIGGER_NO_TYPE  0xFFFF
+
+/* One slot's data for one event of the block, from simpleScanBatch() */
+typedef struct BatchRecordStruct
+{
+  unsigned int   event;		/* Index of the CODA event in events[] */
+  unsigned short rocID;
+  unsigned short bankID;
+  unsigned char  slot;
+  unsigned char  evt;		/* Event of the block */
+  unsigned short pad;
+  unsigned int   offset;	/* Words from the start of the CODA event */
+  unsigned int   length;
+} simpleBatchRecord;
+
+/* Index arena of simpleScanBatch(), owned by the caller */
+typedef struct BatchStruct
+{
+  simpleBatchRecord *record;	/* maxRecords records */
+  int                maxRecords;
+  int                nrecords;	/* Records filled by the last batch */
+  int               *eventStart; /* n+1 entries, or NULL: first record of each event */
+  int               *status;	/* n entries, or NULL: scan status of each event */
+} simpleBatch;
+
+/* Batch status of an event with more records than the whole arena */
+#define SIMPLE_BATCH_TOO_BIG  2
+
+/* A bank skipped by simpleConfigIgnoreUndefinedBlocks(), from simpleGetSkipCounts() */
+typedef struct SkipCountStruct
 {
   int rocID;
   int bankID;
-  int blkIndex[SIMPLE_MAX_SLOTS];
-  int blkTrailerIndex[SIMPLE_MAX_SLOTS];
-  int blkLevel;
-  int evtCounter;
-  unsigned int slotMask;
-  int evtIndex[SIMPLE_MAX_SLOTS][SIMPLE_MAX_BLOCKLEVEL+1];
-  int evtLength[SIMPLE_MAX_SLOTS][SIMPLE_MAX_BLOCKLEVEL+1];
-} bankDataInfo;
+  unsigned long long nbanks;	/* Times it was skipped */
+  unsigned long long nwords;	/* Words of data skipped */
+} simpleSkipCount;
+
+/* Error types counted in simpleStats */
+typedef enum
+  {
+    SIMPLE_STATS_ERROR_EVENT = 0,	/* CODA event, trigger or ROC bank structure */
+    SIMPLE_STATS_ERROR_BANK,		/* Data bank its scan routine could not index */
+    SIMPLE_STATS_ERROR_BLOCK,		/* Block trailer or block level mismatch */
+    SIMPLE_STATS_NERRORS
+  } simpleStatsError;
+
+/* Scan statistics of a context, from simpleGetStats() */
+typedef struct StatsStruct
+{
+  unsigned long long nevents;	/* CODA events scanned */
+  unsigned long long nwords;	/* Words of those events */
+  unsigned long long nbanks;	/* Data banks indexed */
+  unsigned long long nbankWords;	/* Words of those banks */
+  unsigned long long nblockHeaders;
+  unsigned long long neventHeaders;
+  unsigned long long nblockTrailers;
+  unsigned long long nscalerWords;
+  unsigned long long nerrors[SIMPLE_STATS_NERRORS];
+  unsigned long long eventNsec;	/* Time in simpleScanCodaEvent() */
+  unsigned long long bankNsec;	/* Time in simpleScanBank(), summed over threads */
+} simpleStats;
+
+/* Scan statistics of one bank, from simpleGetBankStats() */
+typedef struct BankStatsStruct
+{
+  int rocID;
+  int bankID;
+  unsigned long long nbanks;	/* Times it was indexed */
+  unsigned long long nwords;
+  unsigned long long nerrors;	/* Scans that returned ERROR */
+  unsigned long long nsec;
+} simpleBankStats;
+
+/* Scan context, holds the index of one CODA event */
+typedef struct SimpleCtxStruct simpleCtx;
+
+/* Event pipeline: One reader thread, N scanning workers, events returned in order */
+typedef struct SimplePipelineStruct simplePipeline;
+
+typedef struct PipelineEventStruct
+{
+  simpleCtx          *ctx;	/* Index of this event */
+  unsigned int       *data;	/* Event from the read routine */
+  int                 nwords;
+  int                 isPhysics; /* Only physics events are indexed */
+  int                 status;	/* Return value of simpleCtxScan() */
+  unsigned long long  seq;	/* Order the event was read */
+} simplePipelineEvent;
+
+typedef struct PipelineStatsStruct
+{
+  int                nworkers;
+  unsigned long long nevents;
+  unsigned long long nwords;
+  double             seconds;
+  double             eventRate;	/* events/s */
+  double             wordRate;	/* words/s */
+} simplePipelineStats;
+
+typedef int  (*simpleReadFunc)(void *arg, unsigned int **data, int *nwords);
+typedef void (*simpleFreeFunc)(void *arg, unsigned int *data);
+typedef int  (*simpleEventFunc)(void *arg, simplePipelineEvent *event);
+
+#define SIMPLE_STREAM_MORE  1	/* simpleStreamFeed: Event not complete, feed more words */
+
+/* Memory mapped EVIO file */
+typedef struct SimpleFileStruct simpleFile;
+
+#define SIMPLE_FILE_EOF  1	/* simpleFileRead: No more events */
+
+/* Sidecar index of an EVIO file */
+typedef struct SimpleIndexStruct simpleIndex;
 
 typedef struct OtherBankStruct
 {
@@ -324,25 +685,182 @@ int  simpleConfigBank(int rocID, int tag, int num,
 		 int endian, int isBlocked, void *firstPassRoutine);
 
 int  simpleConfigIgnoreUndefinedBlocks(int ignore);
+int  simpleConfigBankSwap(int rocID, int bankID, int swapMode);
+int  simpleConfigBankHeader(int rocID, int bankID, unsigned int module_header,
+			    unsigned int header_mask);
+int  simpleSetSwapBuffer(unsigned int *buffer, int nwords);
+int  simpleConfigParallelBanks(int nthreads);
+int  simpleConfigLazy(int lazy);
+int  simpleConfigValidate(int level);
+int  simpleConfigStats(int enable);
+int  simpleConfigTrace(int nrecords);
+int  simpleConfigErrorPrint(int perSecond);
+int  simpleConfigKernel(int type);
+const char *simpleGetKernelName();
 
 int  simpleScan(volatile unsigned int *data, int nwords);
 int  simpleScanCodaEvent(volatile unsigned int *data);
 int  simpleScanBank(volatile unsigned int *data, int rocID, int bankNumber);
-
+int  simpleScanBatch(volatile unsigned int **events, const int *lengths, int n,
+		     simpleBatch *out);
+int  simpleStreamStart(volatile unsigned int *data, int bufferWords);
+int  simpleStreamFeed(int nwords, int *nrocs);
+int  simpleScanRing(volatile unsigned int *base, int size, int start);
+
+/* Bank scan routines (firstPassRoutine), simpleModule.c */
+int  simpleScanJLab(simpleBankScan *scan);
+int  simpleScanFADC(simpleBankScan *scan);
+int  simpleScanTI(simpleBankScan *scan);
+simpleScanRoutine simpleGetModuleScanRoutine(int modID);
+slotDataInfo *simpleScanAddSlot(simpleBankScan *scan, int slot);
+simpleEventData *simpleScanAddEvent(simpleBankScan *scan, slotDataInfo *sd);
+void simpleTraceWord(simpleTrace *trace, int debugMask, int kind, int index,
+		     unsigned int word, unsigned int arg);
+void simpleScanError(simpleBankScan *scan, int code, int index, unsigned int word,
+		     int slot, int value, int expected);
+
+int simpleGetRocList(int *rocList);
+int simpleGetBankList(int rocID, int *bankList);
 int simpleGetRocBanks(int rocID, int bankID, int *bankList);
 int simpleGetRocSlotmask(int rocID, int bankID, unsigned int *slotmask);
 int simpleGetRocBlockLevel(int rocID, int bankID, int *blockLevel);
+int simpleGetRocBankSwap(int rocID, int bankID, int *swapMode);
 int simpleGetRocBankData(int rocID, int bankID, unsigned int **buffer);
+int simpleGetRocBankSpan(int rocID, int bankID, simpleSpan *span);
+int simpleGetRocEventView(int rocID, int bankID, const simpleEventData **view, int *nslots);
 
 int simpleGetSlotBlockHeader(int rocID, int bank, int slot, unsigned int *header);
 int simpleGetSlotEventHeader(int rocID, int bank, int slot, int evt, unsigned int *header);
 int simpleGetSlotEventData(int rocID, int bank, int slot, int evt, unsigned int **buffer);
+int simpleGetSlotEventSpan(int rocID, int bank, int slot, int evt, simpleSpan *span);
 int simpleGetSlotBlockTrailer(int rocID, int bank, int slot, unsigned int *trailer);
 
 int simpleGetTriggerBankTimeSegment(unsigned long long **buffer);
 int simpleGetTriggerBankTypeSegment(unsigned short **buffer);
 int simpleGetTriggerBankRocSegment(int rocID, unsigned int **buffer);
 
+int simpleGetTriggerColumns(simpleTriggerColumns *cols, int offset);
+int simpleTriggerBankColumns(const unsigned int *bank, int nevents, int swapped,
+			     simpleTriggerColumns *cols, int offset);
+
+int simpleGetNevents();
+int simpleGetEvent(int evt, simpleEvent *event);
+
+int  simpleCheckSync();
+int  simpleGetSyncStats(simpleSyncStats *stats);
+void simpleResetSync();
+
+int  simpleGetSkipCounts(simpleSkipCount *list, int max);
+void simpleResetSkipCounts();
+int  simpleGetStats(simpleStats *stats);
+int  simpleGetBankStats(simpleBankStats *list, int max);
+void simpleResetStats();
+int  simpleGetTrace(simpleTraceRecord *list, int max);
+void simplePrintTrace(const simpleTraceRecord *list, int n);
+int  simpleGetErrors(simpleError *list, int max);
+int  simpleGetErrorCounts(unsigned long long *counts, int max);
+void simpleResetErrors();
+const char *simpleErrorString(int code);
+void simplePrintError(const simpleError *err);
+
+/* Reentrant versions, using a separate scan context */
+simpleCtx *simpleCtxCreate();
+void simpleCtxDestroy(simpleCtx *ctx);
+simpleCtx *simpleGetDefaultCtx();
+void simpleCtxSetDebug(simpleCtx *ctx, int dbMask);
+int  simpleCtxConfigParallelBanks(simpleCtx *ctx, int nthreads);
+int  simpleCtxConfigLazy(simpleCtx *ctx, int lazy);
+int  simpleCtxConfigValidate(simpleCtx *ctx, int level);
+int  simpleCtxConfigStats(simpleCtx *ctx, int enable);
+int  simpleCtxConfigTrace(simpleCtx *ctx, int nrecords);
+int  simpleCtxConfigErrorPrint(simpleCtx *ctx, int perSecond);
+int  simpleCtxSetSwapBuffer(simpleCtx *ctx, unsigned int *buffer, int nwords);
+
+int  simpleCtxScan(simpleCtx *ctx, volatile unsigned int *data, int nwords);
+int  simpleCtxScanCodaEvent(simpleCtx *ctx, volatile unsigned int *data);
+int  simpleCtxScanBank(simpleCtx *ctx, volatile unsigned int *data, int rocID, int bankNumber);
+int  simpleCtxScanBatch(simpleCtx *ctx, volatile unsigned int **events, const int *lengths,
+			int n, simpleBatch *out);
+int  simpleCtxStreamStart(simpleCtx *ctx, volatile unsigned int *data, int bufferWords);
+int  simpleCtxStreamFeed(simpleCtx *ctx, int nwords, int *nrocs);
+int  simpleCtxScanRing(simpleCtx *ctx, volatile unsigned int *base, int size, int start);
+
+int simpleCtxGetRocList(simpleCtx *ctx, int *rocList);
+int simpleCtxGetBankList(simpleCtx *ctx, int rocID, int *bankList);
+int simpleCtxGetRocBanks(simpleCtx *ctx, int rocID, int bankID, int *bankList);
+int simpleCtxGetRocSlotmask(simpleCtx *ctx, int rocID, int bankID, unsigned int *slotmask);
+int simpleCtxGetRocBlockLevel(simpleCtx *ctx, int rocID, int bankID, int *blockLevel);
+int simpleCtxGetRocBankSwap(simpleCtx *ctx, int rocID, int bankID, int *swapMode);
+int simpleCtxGetRocBankData(simpleCtx *ctx, int rocID, int bankID, unsigned int **buffer);
+int simpleCtxGetRocBankSpan(simpleCtx *ctx, int rocID, int bankID, simpleSpan *span);
+int simpleCtxGetRocEventView(simpleCtx *ctx, int rocID, int bankID,
+			     const simpleEventData **view, int *nslots);
+
+int simpleCtxGetSlotBlockHeader(simpleCtx *ctx, int rocID, int bank, int slot, unsigned int *header);
+int simpleCtxGetSlotEventHeader(simpleCtx *ctx, int rocID, int bank, int slot, int evt,
+				unsigned int *header);
+int simpleCtxGetSlotEventData(simpleCtx *ctx, int rocID, int bank, int slot, int evt,
+			      unsigned int **buffer);
+int simpleCtxGetSlotEventSpan(simpleCtx *ctx, int rocID, int bank, int slot, int evt,
+			      simpleSpan *span);
+int simpleCtxGetSlotBlockTrailer(simpleCtx *ctx, int rocID, int bank, int slot, unsigned int *trailer);
+
+int simpleCtxGetTriggerBankTimeSegment(simpleCtx *ctx, unsigned long long **buffer);
+int simpleCtxGetTriggerBankTypeSegment(simpleCtx *ctx, unsigned short **buffer);
+int simpleCtxGetTriggerBankRocSegment(simpleCtx *ctx, int rocID, unsigned int **buffer);
+int simpleCtxGetTriggerColumns(simpleCtx *ctx, simpleTriggerColumns *cols, int offset);
+
+int simpleCtxGetNevents(simpleCtx *ctx);
+int simpleCtxGetEvent(simpleCtx *ctx, int evt, simpleEvent *event);
+
+int  simpleCtxCheckSync(simpleCtx *ctx);
+int  simpleCtxGetSyncStats(simpleCtx *ctx, simpleSyncStats *stats);
+void simpleCtxResetSync(simpleCtx *ctx);
+
+int  simpleCtxGetSkipCounts(simpleCtx *ctx, simpleSkipCount *list, int max);
+void simpleCtxResetSkipCounts(simpleCtx *ctx);
+int  simpleCtxGetStats(simpleCtx *ctx, simpleStats *stats);
+int  simpleCtxGetBankStats(simpleCtx *ctx, simpleBankStats *list, int max);
+void simpleCtxResetStats(simpleCtx *ctx);
+int  simpleCtxGetTrace(simpleCtx *ctx, simpleTraceRecord *list, int max);
+int  simpleCtxGetErrors(simpleCtx *ctx, simpleError *list, int max);
+int  simpleCtxGetErrorCounts(simpleCtx *ctx, unsigned long long *counts, int max);
+void simpleCtxResetErrors(simpleCtx *ctx);
+
+/* Event pipeline */
+simplePipeline *simplePipelineCreate(int nworkers, int depth, simpleReadFunc readRoutine,
+				     simpleFreeFunc freeRoutine, void *arg);
+int  simplePipelineStart(simplePipeline *pipe);
+int  simplePipelineNext(simplePipeline *pipe, simplePipelineEvent **event);
+int  simplePipelineRelease(simplePipeline *pipe, simplePipelineEvent *event);
+int  simplePipelineRun(simplePipeline *pipe, simpleEventFunc eventRoutine, void *arg);
+int  simplePipelineStop(simplePipeline *pipe);
+void simplePipelineDestroy(simplePipeline *pipe);
+int  simplePipelineGetStats(simplePipeline *pipe, simplePipelineStats *stats);
+
+/* EVIO file reader */
+simpleFile *simpleFileOpen(const char *filename);
+void simpleFileClose(simpleFile *file);
+int  simpleFileRead(void *file, unsigned int **data, int *nwords);
+int  simpleFileRewind(simpleFile *file);
+int  simpleFileTell(simpleFile *file, unsigned long long *block, unsigned long long *event);
+int  simpleFileSeek(simpleFile *file, unsigned long long block, unsigned long long event);
+int  simpleFileIsSwapped(simpleFile *file);
+int  simpleFileReadTriggerColumns(simpleFile *file, simpleTriggerColumns *cols, int *nevents);
+
+/* EVIO file index */
+int  simpleIndexBuild(const char *filename, const char *indexname);
+simpleIndex *simpleIndexOpen(const char *filename, const char *indexname);
+void simpleIndexClose(simpleIndex *index);
+int  simpleIndexGetNblocks(simpleIndex *index);
+int  simpleIndexFindEvent(simpleIndex *index, unsigned long long evnum, int *block, int *evt);
+int  simpleIndexGetBlockInfo(simpleIndex *index, int block, unsigned long long *firstEvent,
+			     int *nevents);
+int  simpleIndexGetEventType(simpleIndex *index, int block, int evt);
+int  simpleIndexGetBlock(simpleIndex *index, int block, unsigned int **data, int *nwords);
+int  simpleIndexGetSlotEventData(simpleIndex *index, int block, int rocID, int bank, int slot,
+				 int evt, unsigned int **buffer);
+
 #ifdef __cplusplus
 }
 #endif
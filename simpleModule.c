@@ -0,0 +1,557 @@
+/*----------------------------------------------------------------------------*/
+/**
+ * @mainpage
+ * <pre>
+ *  Copyright (c) 2014        Southeastern Universities Research Association, *
+ *                            Thomas Jefferson National Accelerator Facility  *
+ *                                                                            *
+ *    This software was developed under a United States Government license    *
+ *    described in the NOTICE file included as part of this distribution.     *
+ *                                                                            *
+ *    Authors: Bryan Moffit                                                   *
+ *             moffit@jlab.org                   Jefferson Lab, MS-12B3       *
+ *             Phone: (757) 269-5660             12000 Jefferson Ave.         *
+ *             Fax:   (757) 269-5800             Newport News, VA 23606       *
+ *                                                                            *
+ *----------------------------------------------------------------------------*
+ *
+ * Description:
+ *     Bank scan routines (firstPassRoutine) for
+ *      (S)econdary (I)nstance (M)ultiblock (P)rocessing (L)ist (E)xtraction
+ *
+ *     Each routine indexes one data bank: the block header, the events
+ *     and the block trailer of each slot.  simpleScanJLab() handles any
+ *     module using the JLab Data Format Standard.  The module routines
+ *     use what they know of their module's data to step over payload
+ *     words, instead of classifying each of them.
+ *
+ * </pre>
+ *----------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <byteswap.h>
+#include "simpleLib.h"
+#include "simpleKernel.h"
+
+/* Number of words after a type defining word that belong to it,
+   and may be skipped.  0 if unknown. */
+typedef int (*simplePayloadFunc)(unsigned int word);
+
+/* fADC250 / fADC125 window raw data header: samples in bits 0-11, two per word */
+#define FADC_WINDOW_RAW_DATA        4
+#define FADC_WINDOW_WIDTH_MASK      0x00000FFF
+
+/* Address of word i of the data, which may wrap around a ring */
+static inline const unsigned int *
+simpleScanPtr(simpleBankScan *scan, int i)
+{
+  if(i < scan->wrap)
+    return &scan->data[i];
+
+  return &scan->wrapData[i - scan->wrap];
+}
+
+static inline unsigned int
+simpleScanWord(simpleBankScan *scan, int i)
+{
+  unsigned int word = *simpleScanPtr(scan, i);
+  return scan->endian ? bswap_32(word) : word;
+}
+
+static int
+simplePayloadJLab(unsigned int word)
+{
+  jlab_data_word_t jdata;
+
+  jdata.raw = word;
+  if(jdata.bf.data_type_tag == SCALER_HEADER)
+    {
+      scaler_header_t sheader;
+      sheader.raw = word;
+      return sheader.bf.scaler_words;
+    }
+
+  return 0;
+}
+
+static int
+simplePayloadFADC(unsigned int word)
+{
+  jlab_data_word_t jdata;
+
+  jdata.raw = word;
+  if(jdata.bf.data_type_tag == FADC_WINDOW_RAW_DATA)
+    return ((word & FADC_WINDOW_WIDTH_MASK) + 1) >> 1;
+
+  return simplePayloadJLab(word);
+}
+
+/* Index a bank of blocked JLab module data.  The kernel finds the type
+   defining words, in chunks of up to SIMPLE_KERNEL_WORDS, so the data
+   words in between are never visited.  payload() says how many words
+   after a defining word may be skipped.  With SIMPLE_VALIDATE_FULL, the
+   word after them must be type defining (or past the bank), otherwise the
+   count is reported, and not used. */
+static int
+simpleScanBlocked(simpleBankScan *scan, simplePayloadFunc payload)
+{
+  int rval = OK;
+  int iword = 0;		/* Index of the current word in scan->data */
+  int index;			/* Index of the current word in the event */
+  int current_event = 0;
+  int nwords = scan->nwords;
+  unsigned int slotNumber = 0;	/* Set in block header, checked in block trailer */
+  int blockStart, nblock, skip;
+  const unsigned int *block;	/* scan->data from blockStart, not across a ring's end */
+  int blkLevel = -1;		/* Block level of the first block */
+  unsigned long long defMask;
+  const simpleKernel *kernel = simpleKernelGet();
+  bankDataInfo *bank = scan->bank;
+  slotDataInfo *sd = NULL;	/* Slot data of the current block */
+  simpleEventData *evt;
+  jlab_data_word_t jdata;
+  block_header_t bheader;
+  block_trailer_t btrailer;
+
+  while(iword < nwords)
+    {
+      blockStart = iword;
+      nblock = nwords - iword;
+      if(nblock > SIMPLE_KERNEL_WORDS)
+	nblock = SIMPLE_KERNEL_WORDS;
+      /* Not across the end of a ring */
+      if((iword < scan->wrap) && (nblock > scan->wrap - iword))
+	nblock = scan->wrap - iword;
+
+      block = simpleScanPtr(scan, blockStart);
+      if(scan->endian)
+	defMask = (*kernel->definingMaskSwap)(block, nblock);
+      else
+	defMask = (*kernel->definingMask)(block, nblock);
+
+      while(defMask)
+	{
+	  iword = blockStart + __builtin_ctzll(defMask);
+	  index = scan->index + iword;
+
+	  jdata.raw = block[iword - blockStart];
+	  if(scan->endian)
+	    jdata.raw = bswap_32(jdata.raw);
+
+	  switch(jdata.bf.data_type_tag)
+	    {
+	    case BLOCK_HEADER: /* 0: BLOCK HEADER */
+	      {
+		bheader.raw = jdata.raw;
+
+		bank->evtCounter = 0; /* Initialize the event counter */
+		slotNumber = bheader.bf.slot_number;
+		SIMPLE_COUNT(scan, nblockHeaders, 1);
+
+		sd = simpleScanAddSlot(scan, slotNumber);
+		if(sd == NULL)
+		  return ERROR;
+
+		sd->blkIndex = index;
+		sd->nevents  = 0;
+		bank->blkLevel   = bheader.bf.number_of_events_in_block;
+
+		SIMPLE_TRACE_WORD(scan, SIMPLE_TRACE_BLOCK_HEADER, index, bheader.raw, 0);
+
+		/* Every slot of the bank should have the same block level */
+		if(scan->validate >= SIMPLE_VALIDATE_FULL)
+		  {
+		    if(blkLevel < 0)
+		      blkLevel = bank->blkLevel;
+		    else if(bank->blkLevel != blkLevel)
+		      {
+			simpleScanError(scan, SIMPLE_ERROR_BLOCK_LEVEL, index, bheader.raw,
+					slotNumber, bank->blkLevel, blkLevel);
+			SIMPLE_COUNT(scan, nblockErrors, 1);
+			rval = ERROR;
+		      }
+		  }
+		break;
+	      }
+
+	    case BLOCK_TRAILER: /* 1: BLOCK TRAILER */
+	      {
+		btrailer.raw = jdata.raw;
+		SIMPLE_COUNT(scan, nblockTrailers, 1);
+
+		if(sd == NULL)
+		  {
+		    /* No block header for this trailer */
+		    sd = simpleScanAddSlot(scan, slotNumber);
+		    if(sd == NULL)
+		      return ERROR;
+		  }
+		sd->blkTrailerIndex = index;
+
+		SIMPLE_TRACE_WORD(scan, SIMPLE_TRACE_BLOCK_TRAILER, index, btrailer.raw, 0);
+
+		/* Obtain the previous event length */
+		if(sd->nevents > 0)
+		  {
+		    current_event = sd->nevents - 1;
+
+		    sd->evt[current_event].length = index - sd->evt[current_event].index;
+		  }
+
+		if(scan->validate >= SIMPLE_VALIDATE_FULL)
+		  {
+		    /* Check the slot number to make sure this block
+		       trailer is associated with the previous block
+		       header */
+		    if(btrailer.bf.slot_number != slotNumber)
+		      {
+			simpleScanError(scan, SIMPLE_ERROR_TRAILER_SLOT, index, btrailer.raw,
+					slotNumber, btrailer.bf.slot_number, slotNumber);
+			SIMPLE_COUNT(scan, nblockErrors, 1);
+			rval = ERROR;
+		      }
+
+		    /* Check the number of words vs. words counted within the block */
+		    if(btrailer.bf.words_in_block !=
+		       (index - sd->blkIndex+1) )
+		      {
+			simpleScanError(scan, SIMPLE_ERROR_TRAILER_WORDS, index, btrailer.raw,
+					slotNumber, btrailer.bf.words_in_block,
+					index - sd->blkIndex + 1);
+			SIMPLE_COUNT(scan, nblockErrors, 1);
+			rval = ERROR;
+		      }
+
+		    /* Check the events found vs. the block level in the block header */
+		    if(sd->nevents != bank->blkLevel)
+		      {
+			simpleScanError(scan, SIMPLE_ERROR_BLOCK_EVENTS, index, btrailer.raw,
+					slotNumber, sd->nevents, bank->blkLevel);
+			SIMPLE_COUNT(scan, nblockErrors, 1);
+			rval = ERROR;
+		      }
+		  }
+
+		slotNumber = 0; /* Initialize for next block */
+		sd = NULL;
+		break;
+	      }
+
+	    case EVENT_HEADER: /* 2: EVENT HEADER */
+	      {
+		SIMPLE_COUNT(scan, neventHeaders, 1);
+
+		SIMPLE_TRACE_WORD(scan, SIMPLE_TRACE_EVENT_HEADER, index, jdata.raw, 0);
+
+		if((slotNumber == 0) || (sd == NULL))
+		  {
+		    simpleScanError(scan, SIMPLE_ERROR_EVENT_HEADER, index, jdata.raw,
+				    -1, 0, 0);
+		    return ERROR;
+		  }
+
+		if(sd->nevents > SIMPLE_MAX_BLOCKLEVEL)
+		  {
+		    simpleScanError(scan, SIMPLE_ERROR_TOO_MANY_EVENTS, index, jdata.raw,
+				    slotNumber, sd->nevents + 1, SIMPLE_MAX_BLOCKLEVEL + 1);
+		    return ERROR;
+		  }
+
+		/* Add this slot to the slotMask */
+		bank->slotMask |= (1 << slotNumber);
+
+		/* Obtain the previous event length */
+		if(sd->nevents > 0)
+		  {
+		    current_event = sd->nevents - 1;
+
+		    sd->evt[current_event].length = index - sd->evt[current_event].index;
+		  }
+
+		evt = simpleScanAddEvent(scan, sd);
+		if(evt == NULL)
+		  return ERROR;
+
+		bank->evtCounter++; /* increment event counter */
+		evt->index = index;
+
+		break;
+	      }
+
+	    default:
+	      /* Step over the words that belong to this one */
+	      skip = (*payload)(jdata.raw);
+
+	      /* A wrong count lands on a data word, or steps over the next
+		 block, event or data header.  Only the word it lands on is
+		 checked, so the words in between are still never visited.
+		 Not scaler counts, which use all 32 bits */
+	      if((skip > 0) && (scan->validate >= SIMPLE_VALIDATE_FULL) &&
+		 (jdata.bf.data_type_tag != SCALER_HEADER) &&
+		 (iword + skip + 1 < nwords) &&
+		 !(simpleScanWord(scan, iword + skip + 1) & DATA_TYPE_DEFINING_MASK))
+		{
+		  simpleScanError(scan, SIMPLE_ERROR_PAYLOAD_COUNT, index, jdata.raw,
+				  slotNumber, skip, 0);
+		  rval = ERROR;
+		  skip = 0;	/* Classify each word after this one instead */
+		}
+
+	      if(jdata.bf.data_type_tag == SCALER_HEADER)
+		{
+		  SIMPLE_COUNT(scan, nscalerWords, skip);
+		  SIMPLE_TRACE_WORD(scan, SIMPLE_TRACE_SCALER_HEADER, index, jdata.raw, skip);
+		}
+	      if(skip > 0)
+		iword += skip;
+	      else
+		SIMPLE_TRACE_WORD(scan, SIMPLE_TRACE_OTHER, index, jdata.raw, 0);
+	    } /* switch(data_type) */
+
+	  iword++;
+
+	  /* Drop the words already passed.  Skipped words may go past the chunk */
+	  if((iword - blockStart) >= SIMPLE_KERNEL_WORDS)
+	    defMask = 0;
+	  else
+	    defMask &= ~0ULL << (iword - blockStart);
+
+	} /* while(defMask) */
+
+      if(iword < blockStart + nblock)
+	iword = blockStart + nblock;
+
+    } /* while(iword<nwords) */
+
+  return rval;
+}
+
+/**
+ * @ingroup Unblock
+ * @brief Index a bank of modules that use the JLab Data Format Standard.
+ *    This is the default firstPassRoutine.
+ *
+ * @param scan  Bank to index
+ *
+ * @return OK if successful, otherwise ERROR
+ */
+int
+simpleScanJLab(simpleBankScan *scan)
+{
+  return simpleScanBlocked(scan, simplePayloadJLab);
+}
+
+/**
+ * @ingroup Unblock
+ * @brief Index a bank of fADC250 or fADC125 data.
+ *    Window raw data samples are stepped over, using the window width
+ *    in their header.
+ *
+ * @param scan  Bank to index
+ *
+ * @return OK if successful, otherwise ERROR
+ */
+int
+simpleScanFADC(simpleBankScan *scan)
+{
+  return simpleScanBlocked(scan, simplePayloadFADC);
+}
+
+/**
+ * @ingroup Unblock
+ * @brief Index a bank of TI (or TS, TD) data.
+ *
+ *    TI event words are not type defining.  After the block header and
+ *    the second block header (nevents), each event starts with a word
+ *    holding its word count, which is used to step to the next event.
+ *    A block trailer found before nevents events ends the block.
+ *
+ * @param scan  Bank to index
+ *
+ * @return OK if successful, otherwise ERROR
+ */
+int
+simpleScanTI(simpleBankScan *scan)
+{
+  int rval = OK;
+  int iword = 0, index, nevents = 0, wordCount;
+  unsigned int word, slotNumber = 0;
+  bankDataInfo *bank = scan->bank;
+  slotDataInfo *sd = NULL;
+  simpleEventData *evt;
+  block_header_t bheader;
+  block_trailer_t btrailer;
+  jlab_data_word_t jdata;
+
+  while(iword < scan->nwords)
+    {
+      index = scan->index + iword;
+      word = simpleScanWord(scan, iword);
+      jdata.raw = word;
+
+      /* Events of this block, up to its trailer */
+      if(sd && (sd->nevents < nevents) &&
+	 !(jdata.bf.data_type_defining && (jdata.bf.data_type_tag == BLOCK_TRAILER)))
+	{
+	  wordCount = word & TRIG_EVENT_HEADER_WORD_COUNT_MASK;
+	  if(iword + wordCount + 1 > scan->nwords)
+	    {
+	      simpleScanError(scan, SIMPLE_ERROR_TI_WORD_COUNT, index, word,
+			      slotNumber, wordCount, scan->nwords - iword - 1);
+	      return ERROR;
+	    }
+
+	  SIMPLE_TRACE_WORD(scan, SIMPLE_TRACE_TI_EVENT, index, word, 0);
+
+	  evt = simpleScanAddEvent(scan, sd);
+	  if(evt == NULL)
+	    return ERROR;
+
+	  bank->slotMask |= (1 << slotNumber);
+	  bank->evtCounter++;
+	  evt->index  = index;
+	  evt->length = wordCount + 1;
+	  SIMPLE_COUNT(scan, neventHeaders, 1);
+
+	  iword += wordCount + 1;
+	  continue;
+	}
+
+      if(jdata.bf.data_type_defining && (jdata.bf.data_type_tag == BLOCK_HEADER))
+	{
+	  bheader.raw = word;
+	  slotNumber = bheader.bf.slot_number;
+	  SIMPLE_COUNT(scan, nblockHeaders, 1);
+
+	  sd = simpleScanAddSlot(scan, slotNumber);
+	  if(sd == NULL)
+	    return ERROR;
+
+	  sd->blkIndex = index;
+	  sd->nevents  = 0;
+	  bank->evtCounter = 0;
+	  bank->blkLevel   = bheader.bf.number_of_events_in_block;
+	  nevents = 0;
+
+	  SIMPLE_TRACE_WORD(scan, SIMPLE_TRACE_BLOCK_HEADER, index, word, 0);
+
+	  /* Second block header has the number of events */
+	  if((iword + 1 < scan->nwords) &&
+	     ((simpleScanWord(scan, iword + 1) & TRIG_HEADER2_ID_MASK) == TRIG_HEADER2_ID_MASK))
+	    {
+	      nevents = simpleScanWord(scan, iword + 1) & TRIG_HEADER2_NEVENTS_MASK;
+	      iword++;
+	    }
+	  else
+	    nevents = bank->blkLevel;
+
+	  if(nevents > SIMPLE_MAX_BLOCKLEVEL + 1)
+	    {
+	      simpleScanError(scan, SIMPLE_ERROR_TOO_MANY_EVENTS, index, word,
+			      slotNumber, nevents, SIMPLE_MAX_BLOCKLEVEL + 1);
+	      return ERROR;
+	    }
+	}
+      else if(jdata.bf.data_type_defining && (jdata.bf.data_type_tag == BLOCK_TRAILER))
+	{
+	  btrailer.raw = word;
+	  SIMPLE_COUNT(scan, nblockTrailers, 1);
+
+	  if(sd == NULL)
+	    {
+	      sd = simpleScanAddSlot(scan, slotNumber);
+	      if(sd == NULL)
+		return ERROR;
+	    }
+	  sd->blkTrailerIndex = index;
+
+	  SIMPLE_TRACE_WORD(scan, SIMPLE_TRACE_BLOCK_TRAILER, index, word, 0);
+
+	  /* Trailer before the last event: the events were not indexed past it */
+	  if(sd->nevents < nevents)
+	    {
+	      simpleScanError(scan, SIMPLE_ERROR_BLOCK_EVENTS, index, word,
+			      slotNumber, sd->nevents, nevents);
+	      SIMPLE_COUNT(scan, nblockErrors, 1);
+	      rval = ERROR;
+	    }
+
+	  if(scan->validate >= SIMPLE_VALIDATE_FULL)
+	    {
+	      /* Check the slot number to make sure this block
+		 trailer is associated with the previous block
+		 header */
+	      if(btrailer.bf.slot_number != slotNumber)
+		{
+		  simpleScanError(scan, SIMPLE_ERROR_TRAILER_SLOT, index, word,
+				  slotNumber, btrailer.bf.slot_number, slotNumber);
+		  SIMPLE_COUNT(scan, nblockErrors, 1);
+		  rval = ERROR;
+		}
+
+	      /* Check the number of words vs. words counted within the block */
+	      if(btrailer.bf.words_in_block != (index - sd->blkIndex + 1))
+		{
+		  simpleScanError(scan, SIMPLE_ERROR_TRAILER_WORDS, index, word,
+				  slotNumber, btrailer.bf.words_in_block,
+				  index - sd->blkIndex + 1);
+		  SIMPLE_COUNT(scan, nblockErrors, 1);
+		  rval = ERROR;
+		}
+
+	      /* Check the events of the block vs. the block level in the block header */
+	      if((sd->nevents == nevents) && (sd->nevents != bank->blkLevel))
+		{
+		  simpleScanError(scan, SIMPLE_ERROR_BLOCK_EVENTS, index, word,
+				  slotNumber, sd->nevents, bank->blkLevel);
+		  SIMPLE_COUNT(scan, nblockErrors, 1);
+		  rval = ERROR;
+		}
+	    }
+
+	  sd = NULL;
+	  slotNumber = 0;
+	}
+
+      iword++;
+    }
+
+  return rval;
+}
+
+/**
+ * @ingroup Unblock
+ * @brief Return the firstPassRoutine for a module type
+ *
+ *    MODID_TI, MODID_TS, MODID_TD:        simpleScanTI
+ *    MODID_FA250, MODID_FA125:            simpleScanFADC
+ *    Others (F1TDC, SSP/VTP, ...):        simpleScanJLab.  Every word of their
+ *      data is type defining, or has no count in its header, so there is
+ *      nothing to step over.
+ *
+ * @param modID  Module type, from jlabModuleTypes
+ *
+ * @return Scan routine, the firstPassRoutine of simpleConfigBank
+ */
+simpleScanRoutine
+simpleGetModuleScanRoutine(int modID)
+{
+  switch(modID)
+    {
+    case MODID_TI:
+    case MODID_TS:
+    case MODID_TD:
+      return simpleScanTI;
+
+    case MODID_FA250:
+    case MODID_FA125:
+      return simpleScanFADC;
+
+    case MODID_F1TDC_V2:
+    case MODID_F1TDC_V3:
+    case MODID_SSP:
+    default:
+      return simpleScanJLab;
+    }
+}
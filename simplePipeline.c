@@ -0,0 +1,546 @@
+/*----------------------------------------------------------------------------*/
+/**
+ * @mainpage
+ * <pre>
+ *  Copyright (c) 2014        Southeastern Universities Research Association, *
+ *                            Thomas Jefferson National Accelerator Facility  *
+ *                                                                            *
+ *    This software was developed under a United States Government license    *
+ *    described in the NOTICE file included as part of this distribution.     *
+ *                                                                            *
+ *    Authors: Bryan Moffit                                                   *
+ *             moffit@jlab.org                   Jefferson Lab, MS-12B3       *
+ *             Phone: (757) 269-5660             12000 Jefferson Ave.         *
+ *             Fax:   (757) 269-5800             Newport News, VA 23606       *
+ *                                                                            *
+ *----------------------------------------------------------------------------*
+ *
+ * Description:
+ *     Multi-threaded event pipeline for
+ *      (S)econdary (I)nstance (M)ultiblock (P)rocessing (L)ist (E)xtraction
+ *
+ *     One reader thread gets events from a user routine, a pool of
+ *     workers index them (each with its own scan context), and the
+ *     consumer receives the indexed events in the order they were read.
+ *
+ * </pre>
+ *----------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include "simpleLib.h"
+
+typedef enum simplePipelineSlotState
+  {
+    SLOT_FREE = 0,		/* Waiting for the reader */
+    SLOT_READ,			/* Waiting for a worker */
+    SLOT_SCANNING,		/* Being indexed */
+    SLOT_DONE,			/* Waiting for the consumer */
+    SLOT_CONSUMER		/* Held by the consumer */
+  } simplePipelineSlotState;
+
+typedef struct PipelineSlotStruct
+{
+  simplePipelineSlotState state;
+  simplePipelineEvent     event;
+} simplePipelineSlot;
+
+struct SimplePipelineStruct
+{
+  int                 nworkers;
+  int                 depth;
+
+  simpleReadFunc      readRoutine;
+  simpleFreeFunc      freeRoutine;
+  void               *userArg;
+
+  simplePipelineSlot *slot;
+  pthread_t           reader;
+  pthread_t          *worker;
+  int                 started;
+
+  pthread_mutex_t     lock;
+  pthread_cond_t      slotFree;
+  pthread_cond_t      slotRead;
+  pthread_cond_t      slotDone;
+
+  unsigned long long  nread;	/* Events read */
+  unsigned long long  nextScan;	/* Next event for a worker */
+  unsigned long long  nextOut;	/* Next event for the consumer */
+  int                 eof;	/* Reader is finished */
+  int                 readStatus;	/* readRoutine status that finished it */
+  int                 quit;	/* Stop requested */
+
+  struct timespec     startTime;
+  struct timespec     lastTime;
+  unsigned long long  nevents;
+  unsigned long long  nwords;
+};
+
+/* Physics events are the only ones with a trigger bank to index */
+static int
+simplePipelineIsPhysics(unsigned int *data, int nwords)
+{
+  bankHeader_t bh;
+
+  if(nwords < 2)
+    return 0;
+
+  bh.raw = data[1];
+
+  return ((bh.bf.type == EVIO_BANK) &&
+	  (bh.bf.tag >= 0xFF50) && (bh.bf.tag <= 0xFF8F));
+}
+
+static void *
+simplePipelineReader(void *arg)
+{
+  simplePipeline *pipe = (simplePipeline *) arg;
+  simplePipelineSlot *slot;
+  unsigned int *data = NULL;
+  int nwords = 0, status;
+
+  while(1)
+    {
+      pthread_mutex_lock(&pipe->lock);
+      slot = &pipe->slot[pipe->nread % pipe->depth];
+      while((slot->state != SLOT_FREE) && !pipe->quit)
+	pthread_cond_wait(&pipe->slotFree, &pipe->lock);
+      if(pipe->quit)
+	{
+	  pthread_mutex_unlock(&pipe->lock);
+	  break;
+	}
+      pthread_mutex_unlock(&pipe->lock);
+
+      status = (*pipe->readRoutine)(pipe->userArg, &data, &nwords);
+      if(status != OK)
+	{
+	  pthread_mutex_lock(&pipe->lock);
+	  pipe->readStatus = status;
+	  pthread_mutex_unlock(&pipe->lock);
+	  break;
+	}
+
+      pthread_mutex_lock(&pipe->lock);
+      slot->event.data   = data;
+      slot->event.nwords = nwords;
+      slot->event.seq    = pipe->nread;
+      slot->event.status = ERROR;
+      slot->event.isPhysics = 0;
+      slot->state = SLOT_READ;
+      pipe->nread++;
+      pthread_cond_signal(&pipe->slotRead);
+      pthread_mutex_unlock(&pipe->lock);
+    }
+
+  pthread_mutex_lock(&pipe->lock);
+  pipe->eof = 1;
+  pthread_cond_broadcast(&pipe->slotRead);
+  pthread_cond_broadcast(&pipe->slotDone);
+  pthread_mutex_unlock(&pipe->lock);
+
+  return NULL;
+}
+
+static void *
+simplePipelineWorker(void *arg)
+{
+  simplePipeline *pipe = (simplePipeline *) arg;
+  simplePipelineSlot *slot;
+
+  while(1)
+    {
+      pthread_mutex_lock(&pipe->lock);
+      while((pipe->nextScan >= pipe->nread) && !pipe->eof && !pipe->quit)
+	pthread_cond_wait(&pipe->slotRead, &pipe->lock);
+
+      if(pipe->quit || (pipe->nextScan >= pipe->nread))
+	{
+	  pthread_mutex_unlock(&pipe->lock);
+	  break;
+	}
+
+      slot = &pipe->slot[pipe->nextScan % pipe->depth];
+      pipe->nextScan++;
+      slot->state = SLOT_SCANNING;
+      pthread_mutex_unlock(&pipe->lock);
+
+      if(simplePipelineIsPhysics(slot->event.data, slot->event.nwords))
+	{
+	  slot->event.isPhysics = 1;
+	  slot->event.status = simpleCtxScan(slot->event.ctx, slot->event.data,
+					     slot->event.nwords);
+	}
+
+      pthread_mutex_lock(&pipe->lock);
+      slot->state = SLOT_DONE;
+      pthread_cond_broadcast(&pipe->slotDone);
+      pthread_mutex_unlock(&pipe->lock);
+    }
+
+  return NULL;
+}
+
+/**
+ * @ingroup Pipeline
+ * @brief Create an event pipeline
+ *
+ * @param nworkers     Number of scanning threads
+ * @param depth        Number of events in flight.  Minimum (and default, if 0) is
+ *                     2 * nworkers.
+ * @param readRoutine  Routine that provides the next event to the reader thread.
+ *                     Returns OK with the event in (*data, *nwords),
+ *                     SIMPLE_FILE_EOF at the end of the stream, otherwise
+ *                     ERROR (as simpleFileRead()).
+ * @param freeRoutine  Routine called with each event once the consumer releases it.
+ *                     May be NULL.
+ * @param arg          Argument passed to readRoutine and freeRoutine
+ *
+ * @return Address of the pipeline if successful, otherwise NULL
+ */
+simplePipeline *
+simplePipelineCreate(int nworkers, int depth, simpleReadFunc readRoutine,
+		     simpleFreeFunc freeRoutine, void *arg)
+{
+  simplePipeline *pipe;
+  int islot;
+
+  if((nworkers < 1) || (readRoutine == NULL))
+    {
+      printf("%s: ERROR: Invalid nworkers (%d) or readRoutine (%p)\n",
+	     __func__, nworkers, readRoutine);
+      return NULL;
+    }
+
+  if(depth < 2 * nworkers)
+    depth = 2 * nworkers;
+
+  pipe = (simplePipeline *) calloc(1, sizeof(simplePipeline));
+  if(pipe == NULL)
+    return NULL;
+
+  pthread_mutex_init(&pipe->lock, NULL);
+  pthread_cond_init(&pipe->slotFree, NULL);
+  pthread_cond_init(&pipe->slotRead, NULL);
+  pthread_cond_init(&pipe->slotDone, NULL);
+
+  pipe->nworkers    = nworkers;
+  pipe->depth       = depth;
+  pipe->readRoutine = readRoutine;
+  pipe->freeRoutine = freeRoutine;
+  pipe->userArg     = arg;
+
+  pipe->slot   = (simplePipelineSlot *) calloc(depth, sizeof(simplePipelineSlot));
+  pipe->worker = (pthread_t *) calloc(nworkers, sizeof(pthread_t));
+  if((pipe->slot == NULL) || (pipe->worker == NULL))
+    {
+      simplePipelineDestroy(pipe);
+      return NULL;
+    }
+
+  for(islot = 0; islot < depth; islot++)
+    {
+      pipe->slot[islot].event.ctx = simpleCtxCreate();
+      if(pipe->slot[islot].event.ctx == NULL)
+	{
+	  simplePipelineDestroy(pipe);
+	  return NULL;
+	}
+    }
+
+  return pipe;
+}
+
+/**
+ * @ingroup Pipeline
+ * @brief Start the reader and worker threads
+ *
+ * @param pipe  Pipeline from simplePipelineCreate()
+ *
+ * @return OK if successful, otherwise ERROR
+ */
+int
+simplePipelineStart(simplePipeline *pipe)
+{
+  int iworker;
+
+  if(pipe->started)
+    {
+      printf("%s: ERROR: Pipeline already started\n", __func__);
+      return ERROR;
+    }
+
+  /* From the start of the stream, or where the last run was stopped.
+     Stop returned every slot */
+  pipe->nread      = 0;
+  pipe->nextScan   = 0;
+  pipe->nextOut    = 0;
+  pipe->eof        = 0;
+  pipe->quit       = 0;
+  pipe->readStatus = SIMPLE_FILE_EOF;
+  pipe->nevents    = 0;
+  pipe->nwords     = 0;
+
+  clock_gettime(CLOCK_MONOTONIC, &pipe->startTime);
+  pipe->lastTime = pipe->startTime;
+
+  if(pthread_create(&pipe->reader, NULL, simplePipelineReader, pipe) != 0)
+    {
+      printf("%s: ERROR: Unable to start reader thread\n", __func__);
+      return ERROR;
+    }
+  pipe->started = 1;
+
+  for(iworker = 0; iworker < pipe->nworkers; iworker++)
+    {
+      if(pthread_create(&pipe->worker[iworker], NULL, simplePipelineWorker, pipe) != 0)
+	{
+	  printf("%s: ERROR: Unable to start worker thread %d\n", __func__, iworker);
+	  pipe->nworkers = iworker;
+	  simplePipelineStop(pipe);
+	  return ERROR;
+	}
+    }
+
+  return OK;
+}
+
+/**
+ * @ingroup Pipeline
+ * @brief Get the next indexed event, in the order they were read.
+ *        Blocks until it is ready.
+ *
+ *    The event's index is available through its context (event->ctx) with
+ *    the simpleCtxGet* routines, until it is returned with
+ *    simplePipelineRelease().
+ *
+ * @param pipe   Pipeline from simplePipelineCreate()
+ * @param event  Where to store the address of the event
+ *
+ * @return OK if successful.  At the end of the stream, SIMPLE_FILE_EOF, or
+ *         ERROR if the readRoutine failed.  ERROR if the pipeline was stopped.
+ */
+int
+simplePipelineNext(simplePipeline *pipe, simplePipelineEvent **event)
+{
+  simplePipelineSlot *slot;
+  int status;
+
+  pthread_mutex_lock(&pipe->lock);
+  while(1)
+    {
+      if(pipe->quit || (pipe->eof && (pipe->nextOut >= pipe->nread)))
+	{
+	  status = pipe->quit ? ERROR : pipe->readStatus;
+	  pthread_mutex_unlock(&pipe->lock);
+	  return (status == SIMPLE_FILE_EOF) ? SIMPLE_FILE_EOF : ERROR;
+	}
+
+      slot = &pipe->slot[pipe->nextOut % pipe->depth];
+      if((pipe->nextOut < pipe->nread) && (slot->state == SLOT_DONE))
+	break;
+
+      pthread_cond_wait(&pipe->slotDone, &pipe->lock);
+    }
+
+  slot->state = SLOT_CONSUMER;
+  pipe->nextOut++;
+
+  pipe->nevents++;
+  pipe->nwords += slot->event.nwords;
+  pthread_mutex_unlock(&pipe->lock);
+
+  clock_gettime(CLOCK_MONOTONIC, &pipe->lastTime);
+
+  *event = &slot->event;
+
+  return OK;
+}
+
+/**
+ * @ingroup Pipeline
+ * @brief Return an event from simplePipelineNext() to the pipeline.
+ *
+ * @param pipe   Pipeline from simplePipelineCreate()
+ * @param event  Event from simplePipelineNext()
+ *
+ * @return OK if successful, otherwise ERROR
+ */
+int
+simplePipelineRelease(simplePipeline *pipe, simplePipelineEvent *event)
+{
+  simplePipelineSlot *slot = &pipe->slot[event->seq % pipe->depth];
+
+  if((&slot->event != event) || (slot->state != SLOT_CONSUMER))
+    {
+      printf("%s: ERROR: Event %llu not held by the consumer\n",
+	     __func__, event->seq);
+      return ERROR;
+    }
+
+  if(pipe->freeRoutine)
+    (*pipe->freeRoutine)(pipe->userArg, event->data);
+
+  pthread_mutex_lock(&pipe->lock);
+  event->data = NULL;
+  slot->state = SLOT_FREE;
+  pthread_cond_signal(&pipe->slotFree);
+  pthread_mutex_unlock(&pipe->lock);
+
+  return OK;
+}
+
+/**
+ * @ingroup Pipeline
+ * @brief Start the pipeline, and call a routine with every indexed event,
+ *        in the order they were read.  Returns at the end of the stream,
+ *        or when the routine returns something other than OK.
+ *
+ * @param pipe          Pipeline from simplePipelineCreate()
+ * @param eventRoutine  Routine to call with each event
+ * @param arg           Argument passed to eventRoutine
+ *
+ * @return OK at the end of the stream, ERROR if the readRoutine failed,
+ *         otherwise what eventRoutine returned
+ */
+int
+simplePipelineRun(simplePipeline *pipe, simpleEventFunc eventRoutine, void *arg)
+{
+  simplePipelineEvent *event;
+  int rval = OK, status;
+
+  if(!pipe->started)
+    {
+      if(simplePipelineStart(pipe) != OK)
+	return ERROR;
+    }
+
+  while((status = simplePipelineNext(pipe, &event)) == OK)
+    {
+      rval = (*eventRoutine)(arg, event);
+
+      simplePipelineRelease(pipe, event);
+
+      if(rval != OK)
+	break;
+    }
+
+  if((rval == OK) && (status != SIMPLE_FILE_EOF))
+    rval = ERROR;
+
+  simplePipelineStop(pipe);
+
+  return rval;
+}
+
+/**
+ * @ingroup Pipeline
+ * @brief Stop and join the reader and worker threads.  Events not
+ *        yet received by the consumer are dropped.
+ *
+ * @param pipe   Pipeline from simplePipelineCreate()
+ *
+ * @return OK if successful, otherwise ERROR
+ */
+int
+simplePipelineStop(simplePipeline *pipe)
+{
+  int iworker, islot;
+
+  if(!pipe->started)
+    return OK;
+
+  pthread_mutex_lock(&pipe->lock);
+  pipe->quit = 1;
+  pthread_cond_broadcast(&pipe->slotFree);
+  pthread_cond_broadcast(&pipe->slotRead);
+  pthread_cond_broadcast(&pipe->slotDone);
+  pthread_mutex_unlock(&pipe->lock);
+
+  pthread_join(pipe->reader, NULL);
+  for(iworker = 0; iworker < pipe->nworkers; iworker++)
+    pthread_join(pipe->worker[iworker], NULL);
+
+  pipe->started = 0;
+
+  /* Return events still held by the pipeline */
+  for(islot = 0; islot < pipe->depth; islot++)
+    {
+      if((pipe->slot[islot].state != SLOT_FREE) && pipe->slot[islot].event.data)
+	{
+	  if(pipe->freeRoutine)
+	    (*pipe->freeRoutine)(pipe->userArg, pipe->slot[islot].event.data);
+	  pipe->slot[islot].event.data = NULL;
+	}
+      pipe->slot[islot].state = SLOT_FREE;
+    }
+
+  return OK;
+}
+
+/**
+ * @ingroup Pipeline
+ * @brief Stop the pipeline, and free it
+ *
+ * @param pipe   Pipeline from simplePipelineCreate()
+ */
+void
+simplePipelineDestroy(simplePipeline *pipe)
+{
+  int islot;
+
+  if(pipe == NULL)
+    return;
+
+  simplePipelineStop(pipe);
+
+  pthread_mutex_destroy(&pipe->lock);
+  pthread_cond_destroy(&pipe->slotFree);
+  pthread_cond_destroy(&pipe->slotRead);
+  pthread_cond_destroy(&pipe->slotDone);
+
+  if(pipe->slot)
+    {
+      for(islot = 0; islot < pipe->depth; islot++)
+	simpleCtxDestroy(pipe->slot[islot].event.ctx);
+      free(pipe->slot);
+    }
+
+  free(pipe->worker);
+  free(pipe);
+}
+
+/**
+ * @ingroup Pipeline
+ * @brief Return the event and word rates seen by the consumer, from
+ *        simplePipelineStart() to the last event it received.
+ *
+ * @param pipe   Pipeline from simplePipelineCreate()
+ * @param stats  Where to store the statistics
+ *
+ * @return OK if successful, otherwise ERROR
+ */
+int
+simplePipelineGetStats(simplePipeline *pipe, simplePipelineStats *stats)
+{
+  double elapsed;
+
+  pthread_mutex_lock(&pipe->lock);
+  stats->nworkers = pipe->nworkers;
+  stats->nevents  = pipe->nevents;
+  stats->nwords   = pipe->nwords;
+  pthread_mutex_unlock(&pipe->lock);
+
+  elapsed = (pipe->lastTime.tv_sec - pipe->startTime.tv_sec) +
+    1e-9 * (pipe->lastTime.tv_nsec - pipe->startTime.tv_nsec);
+
+  stats->seconds = elapsed;
+  stats->eventRate = (elapsed > 0) ? stats->nevents / elapsed : 0;
+  stats->wordRate  = (elapsed > 0) ? stats->nwords / elapsed : 0;
+
+  return OK;
+}
@@ -0,0 +1,322 @@
+/*----------------------------------------------------------------------------*/
+/**
+ * @mainpage
+ * <pre>
+ *  Copyright (c) 2014        Southeastern Universities Research Association, *
+ *                            Thomas Jefferson National Accelerator Facility  *
+ *                                                                            *
+ *    This software was developed under a United States Government license    *
+ *    described in the NOTICE file included as part of this distribution.     *
+ *                                                                            *
+ *    Authors: Bryan Moffit                                                   *
+ *             moffit@jlab.org                   Jefferson Lab, MS-12B3       *
+ *             Phone: (757) 269-5660             12000 Jefferson Ave.         *
+ *             Fax:   (757) 269-5800             Newport News, VA 23606       *
+ *                                                                            *
+ *----------------------------------------------------------------------------*
+ *
+ * Description:
+ *     Small persistent thread pool with work stealing.
+ *
+ *     simpleTaskPoolRun() deals the tasks round-robin to a queue per
+ *     worker, with the calling thread as worker 0.  Workers take tasks
+ *     from the back of their own queue, then steal from the front of the
+ *     others until every queue is empty.  Give the tasks in order of
+ *     decreasing cost for the best balance.
+ *
+ * </pre>
+ *----------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+#include "simpleLib.h"
+#include "simpleTaskPool.h"
+
+typedef struct TaskQueueStruct
+{
+  pthread_spinlock_t lock;
+  int  head;			/* Next task to steal */
+  int  tail;			/* One past the next task for the owner */
+  int  size;
+  int *task;
+} simpleTaskQueue;
+
+struct SimpleTaskPoolStruct
+{
+  int              nworkers;	/* Including the calling thread */
+  pthread_t       *thread;
+  simpleTaskQueue *queue;
+
+  pthread_mutex_t  lock;
+  pthread_cond_t   start;
+  pthread_cond_t   idle;
+  unsigned int     gen;		/* Incremented for each run */
+  int              active;	/* Pool threads working on the current run */
+  int              quit;
+
+  /* Current run */
+  simpleTaskFunc   func;
+  void            *arg;
+  int              remaining;	/* Tasks not yet finished */
+};
+
+typedef struct TaskWorkerArgStruct
+{
+  simpleTaskPool *pool;
+  int             iworker;
+} simpleTaskWorkerArg;
+
+/* Take the next task from the worker's own queue, else steal one.
+   Returns -1 when every queue is empty. */
+static int
+simpleTaskNext(simpleTaskPool *pool, int iworker)
+{
+  simpleTaskQueue *q = &pool->queue[iworker];
+  int itask = -1, ivictim;
+
+  pthread_spin_lock(&q->lock);
+  if(q->tail > q->head)
+    itask = q->task[--q->tail];
+  pthread_spin_unlock(&q->lock);
+
+  for(ivictim = 1; (itask < 0) && (ivictim < pool->nworkers); ivictim++)
+    {
+      q = &pool->queue[(iworker + ivictim) % pool->nworkers];
+
+      pthread_spin_lock(&q->lock);
+      if(q->tail > q->head)
+	itask = q->task[q->head++];
+      pthread_spin_unlock(&q->lock);
+    }
+
+  return itask;
+}
+
+static void
+simpleTaskWork(simpleTaskPool *pool, int iworker)
+{
+  int itask;
+
+  while((itask = simpleTaskNext(pool, iworker)) >= 0)
+    {
+      (*pool->func)(pool->arg, itask, iworker);
+      __atomic_sub_fetch(&pool->remaining, 1, __ATOMIC_RELEASE);
+    }
+}
+
+static void *
+simpleTaskThread(void *arg)
+{
+  simpleTaskWorkerArg *warg = (simpleTaskWorkerArg *) arg;
+  simpleTaskPool *pool = warg->pool;
+  int iworker = warg->iworker;
+  unsigned int gen = 0;
+
+  free(warg);
+
+  while(1)
+    {
+      pthread_mutex_lock(&pool->lock);
+      while((pool->gen == gen) && !pool->quit)
+	pthread_cond_wait(&pool->start, &pool->lock);
+      if(pool->quit)
+	{
+	  pthread_mutex_unlock(&pool->lock);
+	  break;
+	}
+      gen = pool->gen;
+      pool->active++;
+      pthread_mutex_unlock(&pool->lock);
+
+      simpleTaskWork(pool, iworker);
+
+      pthread_mutex_lock(&pool->lock);
+      if(--pool->active == 0)
+	pthread_cond_signal(&pool->idle);
+      pthread_mutex_unlock(&pool->lock);
+    }
+
+  return NULL;
+}
+
+/**
+ * @ingroup TaskPool
+ * @brief Create a task pool
+ *
+ * @param nthreads  Number of threads to start.  The thread calling
+ *                  simpleTaskPoolRun() also works on the tasks.
+ *
+ * @return Address of the pool if successful, otherwise NULL
+ */
+simpleTaskPool *
+simpleTaskPoolCreate(int nthreads)
+{
+  simpleTaskPool *pool;
+  simpleTaskWorkerArg *warg;
+  int iworker;
+
+  if(nthreads < 0)
+    return NULL;
+
+  pool = (simpleTaskPool *) calloc(1, sizeof(simpleTaskPool));
+  if(pool == NULL)
+    return NULL;
+
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->start, NULL);
+  pthread_cond_init(&pool->idle, NULL);
+
+  pool->nworkers = nthreads + 1;
+  pool->queue  = (simpleTaskQueue *) calloc(pool->nworkers, sizeof(simpleTaskQueue));
+  pool->thread = (pthread_t *) calloc(pool->nworkers, sizeof(pthread_t));
+  if((pool->queue == NULL) || (pool->thread == NULL))
+    {
+      free(pool->queue);
+      free(pool->thread);
+      free(pool);
+      return NULL;
+    }
+
+  for(iworker = 0; iworker < pool->nworkers; iworker++)
+    pthread_spin_init(&pool->queue[iworker].lock, PTHREAD_PROCESS_PRIVATE);
+
+  for(iworker = 1; iworker < pool->nworkers; iworker++)
+    {
+      warg = (simpleTaskWorkerArg *) malloc(sizeof(simpleTaskWorkerArg));
+      if(warg)
+	{
+	  warg->pool = pool;
+	  warg->iworker = iworker;
+	}
+
+      if((warg == NULL) ||
+	 (pthread_create(&pool->thread[iworker], NULL, simpleTaskThread, warg) != 0))
+	{
+	  printf("%s: ERROR: Unable to start thread %d\n", __func__, iworker);
+	  free(warg);
+	  pool->nworkers = iworker;
+	  simpleTaskPoolDestroy(pool);
+	  return NULL;
+	}
+    }
+
+  return pool;
+}
+
+/**
+ * @ingroup TaskPool
+ * @brief Stop the threads and free the pool
+ *
+ * @param pool  Pool from simpleTaskPoolCreate()
+ */
+void
+simpleTaskPoolDestroy(simpleTaskPool *pool)
+{
+  int iworker;
+
+  if(pool == NULL)
+    return;
+
+  pthread_mutex_lock(&pool->lock);
+  pool->quit = 1;
+  pthread_cond_broadcast(&pool->start);
+  pthread_mutex_unlock(&pool->lock);
+
+  for(iworker = 1; iworker < pool->nworkers; iworker++)
+    pthread_join(pool->thread[iworker], NULL);
+
+  for(iworker = 0; iworker < pool->nworkers; iworker++)
+    {
+      pthread_spin_destroy(&pool->queue[iworker].lock);
+      free(pool->queue[iworker].task);
+    }
+
+  pthread_mutex_destroy(&pool->lock);
+  pthread_cond_destroy(&pool->start);
+  pthread_cond_destroy(&pool->idle);
+
+  free(pool->queue);
+  free(pool->thread);
+  free(pool);
+}
+
+/**
+ * @ingroup TaskPool
+ * @brief Return the number of workers, including the calling thread
+ */
+int
+simpleTaskPoolWorkers(simpleTaskPool *pool)
+{
+  return pool->nworkers;
+}
+
+/**
+ * @ingroup TaskPool
+ * @brief Run tasks 0 to ntasks-1 with the pool, and wait for them to finish.
+ *
+ * @param pool    Pool from simpleTaskPoolCreate()
+ * @param func    Routine that runs one task
+ * @param arg     Argument passed to func
+ * @param ntasks  Number of tasks
+ *
+ * @return OK if successful, otherwise ERROR
+ */
+int
+simpleTaskPoolRun(simpleTaskPool *pool, simpleTaskFunc func, void *arg, int ntasks)
+{
+  int iworker, itask;
+
+  pthread_mutex_lock(&pool->lock);
+
+  /* Threads may still be looking for work from the previous run */
+  while(pool->active > 0)
+    pthread_cond_wait(&pool->idle, &pool->lock);
+
+  for(iworker = 0; iworker < pool->nworkers; iworker++)
+    {
+      simpleTaskQueue *q = &pool->queue[iworker];
+      int need = (ntasks + pool->nworkers - 1) / pool->nworkers;
+
+      if(q->size < need)
+	{
+	  int *task = (int *) realloc(q->task, need * sizeof(int));
+	  if(task == NULL)
+	    {
+	      pthread_mutex_unlock(&pool->lock);
+	      return ERROR;
+	    }
+	  q->task = task;
+	  q->size = need;
+	}
+      q->head = 0;
+      q->tail = 0;
+    }
+
+  /* Deal them out.  Owners take from the tail, so reverse the order
+     to have each worker start with its most expensive task, and
+     thieves take the cheapest ones from the head */
+  for(itask = 0; itask < ntasks; itask++)
+    pool->queue[itask % pool->nworkers].tail++;
+  for(itask = 0; itask < ntasks; itask++)
+    {
+      simpleTaskQueue *q = &pool->queue[itask % pool->nworkers];
+      q->task[q->tail - 1 - itask / pool->nworkers] = itask;
+    }
+
+  pool->func = func;
+  pool->arg = arg;
+  pool->remaining = ntasks;
+  pool->gen++;
+  pthread_cond_broadcast(&pool->start);
+  pthread_mutex_unlock(&pool->lock);
+
+  simpleTaskWork(pool, 0);
+
+  /* Wait for tasks still running on other threads */
+  while(__atomic_load_n(&pool->remaining, __ATOMIC_ACQUIRE) > 0)
+    sched_yield();
+
+  return OK;
+}
@@ -0,0 +1,31 @@
+#ifndef __SIMPLETASKPOOLH__
+#define __SIMPLETASKPOOLH__
+/*----------------------------------------------------------------------------*/
+/**
+ * <pre>
+ *  Copyright (c) 2014        Southeastern Universities Research Association, *
+ *                            Thomas Jefferson National Accelerator Facility  *
+ *                                                                            *
+ *    This software was developed under a United States Government license    *
+ *    described in the NOTICE file included as part of this distribution.     *
+ *                                                                            *
+ *----------------------------------------------------------------------------*
+ *
+ * Description:
+ *     Internal header for the simple library's work-stealing task pool.
+ *     Not installed.
+ *
+ * </pre>
+ *----------------------------------------------------------------------------*/
+
+typedef struct SimpleTaskPoolStruct simpleTaskPool;
+
+/* Run task itask, on worker iworker (0 is the calling thread) */
+typedef void (*simpleTaskFunc)(void *arg, int itask, int iworker);
+
+simpleTaskPool *simpleTaskPoolCreate(int nthreads);
+void simpleTaskPoolDestroy(simpleTaskPool *pool);
+int  simpleTaskPoolWorkers(simpleTaskPool *pool);
+int  simpleTaskPoolRun(simpleTaskPool *pool, simpleTaskFunc func, void *arg, int ntasks);
+
+#endif /* __SIMPLETASKPOOLH__ */
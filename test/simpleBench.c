@@ -0,0 +1,264 @@
+/*
+ * File:
+ *    simpleBench.c
+ *
+ * Description:
+ *    Time simpleScan() and the data access routines over every physics
+ *    event of an EVIO file (e.g. one written by simpleGen), and report
+ *    events/s, words/s and ns/word.
+ *
+ *    usage: simpleBench [-e] [-s] [-p passes] [-v level] <file>
+ *       -e  Configure the module data banks as big endian (simpleGen -e)
+ *       -s  Turn on the scan statistics, and print them
+ *       -v  Validation level: 0 off, 1 fast, 2 full (default)
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include "simpleLib.h"
+
+#define BENCH_MAX_BANKS  1024
+
+typedef struct
+{
+  int rocID;
+  int bankID;
+} benchBank;
+
+static benchBank bankList[BENCH_MAX_BANKS];
+static int nbankList = 0;
+
+static int
+benchIsPhysics(unsigned int *data)
+{
+  unsigned int tag = data[1] >> 16;
+
+  return ((tag >= 0xFF50) && (tag <= 0xFF8F));
+}
+
+/* Find the (rocID, bank) pairs of the ROC banks of one event */
+static void
+benchFindBanks(unsigned int *data, int nwords)
+{
+  int iword = 2, rocEnd, ibank;
+
+  /* Skip the trigger bank */
+  iword += data[iword] + 1;
+
+  while((iword < nwords) && (nbankList < BENCH_MAX_BANKS))
+    {
+      int rocID = (data[iword + 1] >> 16) & 0x0FFF;
+      rocEnd = iword + data[iword] + 1;
+      iword += 2;
+
+      while((iword < rocEnd) && (nbankList < BENCH_MAX_BANKS))
+	{
+	  int bankID = data[iword + 1] >> 16;
+
+	  for(ibank = 0; ibank < nbankList; ibank++)
+	    if((bankList[ibank].rocID == rocID) && (bankList[ibank].bankID == bankID))
+	      break;
+
+	  if(ibank == nbankList)
+	    {
+	      bankList[nbankList].rocID  = rocID;
+	      bankList[nbankList].bankID = bankID;
+	      nbankList++;
+	    }
+	  iword += data[iword] + 1;
+	}
+      iword = rocEnd;
+    }
+}
+
+/* Touch everything indexed, as an analysis would */
+static unsigned int
+benchAccess()
+{
+  unsigned int sum = 0, slotmask, header, *buf;
+  unsigned long long *time;
+  unsigned short *type;
+  int ibank, islot, ievt, blockLevel, len;
+
+  len = simpleGetTriggerBankTimeSegment(&time);
+  if(len > 0)
+    sum += (unsigned int)time[len - 1];
+
+  len = simpleGetTriggerBankTypeSegment(&type);
+  if(len > 0)
+    sum += type[0];
+
+  for(ibank = 0; ibank < nbankList; ibank++)
+    {
+      int rocID = bankList[ibank].rocID, bankID = bankList[ibank].bankID;
+
+      if(simpleGetRocSlotmask(rocID, bankID, &slotmask) < 0)
+	continue;
+      simpleGetRocBlockLevel(rocID, bankID, &blockLevel);
+
+      for(islot = 0; islot < SIMPLE_MAX_SLOTS; islot++)
+	{
+	  if((slotmask & (1 << islot)) == 0)
+	    continue;
+
+	  simpleGetSlotBlockHeader(rocID, bankID, islot, &header);
+	  sum += header;
+
+	  for(ievt = 0; ievt < blockLevel; ievt++)
+	    {
+	      simpleGetSlotEventHeader(rocID, bankID, islot, ievt, &header);
+	      len = simpleGetSlotEventData(rocID, bankID, islot, ievt, &buf);
+	      if(len > 0)
+		sum += header + buf[len - 1];
+	    }
+
+	  simpleGetSlotBlockTrailer(rocID, bankID, islot, &header);
+	  sum += header;
+	}
+    }
+
+  return sum;
+}
+
+/* Print the scan statistics, with the time of each bank */
+static void
+benchPrintStats()
+{
+  simpleStats st;
+  simpleBankStats bs[BENCH_MAX_BANKS];
+  int ibank, nbanks;
+
+  simpleGetStats(&st);
+  printf("stats: %llu events, %llu words, %llu banks, %llu bank words\n",
+	 st.nevents, st.nwords, st.nbanks, st.nbankWords);
+  printf("       %llu block headers, %llu event headers, %llu block trailers, "
+	 "%llu scaler words\n",
+	 st.nblockHeaders, st.neventHeaders, st.nblockTrailers, st.nscalerWords);
+  printf("       errors: %llu event, %llu bank, %llu block\n",
+	 st.nerrors[SIMPLE_STATS_ERROR_EVENT], st.nerrors[SIMPLE_STATS_ERROR_BANK],
+	 st.nerrors[SIMPLE_STATS_ERROR_BLOCK]);
+  printf("       %.3f s in simpleScanCodaEvent, %.3f s in simpleScanBank\n",
+	 1e-9 * st.eventNsec, 1e-9 * st.bankNsec);
+
+  nbanks = simpleGetBankStats(bs, BENCH_MAX_BANKS);
+  if(nbanks > BENCH_MAX_BANKS)
+    nbanks = BENCH_MAX_BANKS;
+
+  printf("%6s %6s %12s %14s %8s %10s\n",
+	 "rocID", "bankID", "banks", "words", "errors", "ns/word");
+  for(ibank = 0; ibank < nbanks; ibank++)
+    printf("%6d %#6x %12llu %14llu %8llu %10.3f\n",
+	   bs[ibank].rocID, bs[ibank].bankID, bs[ibank].nbanks, bs[ibank].nwords,
+	   bs[ibank].nerrors, bs[ibank].nwords ? (double)bs[ibank].nsec / bs[ibank].nwords : 0);
+}
+
+static double
+benchNow()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+int
+main(int argc, char **argv)
+{
+  simpleFile *file;
+  unsigned int *data, sum = 0;
+  unsigned long long nevents = 0, ntriggers = 0, nwords = 0;
+  int opt, nw, ipass, npasses = 5, bigEndian = 0, stats = 0, ibank, status;
+  int validate = SIMPLE_VALIDATE_FULL;
+  double start, seconds;
+
+  while((opt = getopt(argc, argv, "esp:v:h")) != -1)
+    {
+      switch(opt)
+	{
+	case 'e': bigEndian = 1; break;
+	case 's': stats = 1; break;
+	case 'p': npasses = atoi(optarg); break;
+	case 'v': validate = atoi(optarg); break;
+	default:
+	  printf("usage: %s [-e] [-s] [-p passes] [-v level] <file>\n", argv[0]);
+	  exit(-1);
+	}
+    }
+
+  if((optind >= argc) || (npasses < 1))
+    {
+      printf("usage: %s [-e] [-s] [-p passes] [-v level] <file>\n", argv[0]);
+      exit(-1);
+    }
+
+  file = simpleFileOpen(argv[optind]);
+  if(file == NULL)
+    exit(-1);
+
+  simpleInit();
+  if(simpleConfigValidate(validate) != OK)
+    exit(-1);
+  if(stats && (simpleConfigStats(1) != OK))
+    exit(-1);
+
+  /* Warm up: page in (and swap) the file, and find the banks */
+  while(simpleFileRead(file, &data, &nw) == OK)
+    {
+      if(benchIsPhysics(data) && (nbankList == 0))
+	benchFindBanks(data, nw);
+    }
+
+  if(bigEndian)
+    for(ibank = 0; ibank < nbankList; ibank++)
+      simpleConfigBank(bankList[ibank].rocID, bankList[ibank].bankID, 0, 1, 1, NULL);
+
+  start = benchNow();
+  for(ipass = 0; ipass < npasses; ipass++)
+    {
+      simpleFileRewind(file);
+      while((status = simpleFileRead(file, &data, &nw)) == OK)
+	{
+	  if(!benchIsPhysics(data))
+	    continue;
+
+	  if(simpleScan(data, nw) != OK)
+	    {
+	      printf("ERROR: simpleScan failed for event %llu\n", nevents);
+	      exit(-1);
+	    }
+	  sum += benchAccess();
+
+	  nevents++;
+	  ntriggers += data[1] & 0xFF;
+	  nwords += nw;
+	}
+
+      if(status != SIMPLE_FILE_EOF)
+	exit(-1);
+    }
+  seconds = benchNow() - start;
+
+  simpleFileClose(file);
+
+  if((nevents == 0) || (seconds <= 0))
+    {
+      printf("No physics events in %s\n", argv[optind]);
+      exit(-1);
+    }
+
+  printf("%s: %d passes, %d banks, kernel %s, validate %d (checksum 0x%08x)\n",
+	 argv[optind], npasses, nbankList, simpleGetKernelName(), validate, sum);
+  printf("%14s %14s %14s %14s %10s\n",
+	 "events/s", "triggers/s", "words/s", "ns/word", "seconds");
+  printf("%14.1f %14.1f %14.1f %14.3f %10.3f\n",
+	 nevents / seconds, ntriggers / seconds, nwords / seconds,
+	 1e9 * seconds / nwords, seconds);
+
+  if(stats)
+    benchPrintStats();
+
+  return 0;
+}
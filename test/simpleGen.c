@@ -0,0 +1,387 @@
+/*
+ * File:
+ *    simpleGen.c
+ *
+ * Description:
+ *    Write an EVIO (version 4) file of synthetic CODA 3 physics events,
+ *    for testing and benchmarking the simple library.
+ *
+ *    Each event has a trigger bank (event number and timestamps, event
+ *    types, and a segment for each ROC), and ROC banks of blocked
+ *    JLab module data banks (fADC250 style block header, event header,
+ *    trigger time, window raw data, block trailer and filler).
+ *
+ *    usage: simpleGen [options] <file>
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <byteswap.h>
+#include "simpleLib.h"
+
+/* EVIO version 4 block header */
+#define EVIO_MAGIC              0xc0da0100
+#define EVIO_VERSION            4
+#define EVIO_LAST_BLOCK_MASK    (1<<9)
+#define EVIO_BLOCK_MAX_WORDS    (1<<20)
+#define EVIO_BLOCK_MAX_EVENTS   10000
+
+#define GEN_TRIGGER_BANK_TAG    0xFF21
+#define GEN_PHYSICS_EVENT_TAG   0xFF50
+#define GEN_FIRST_BANK_TAG      3
+#define GEN_FIRST_SLOT          3
+#define GEN_ROC_SEGMENT_WORDS   2
+#define GEN_SAMPLE_WORDS        16	/* Words of samples per channel */
+
+typedef struct
+{
+  int nevents;			/* CODA events (blocks of blockLevel events) */
+  int nrocs;
+  int nbanks;			/* Banks per ROC */
+  int nslots;			/* Slots per bank */
+  int blockLevel;
+  int wordsPerEvent;		/* Module data words, per slot and event */
+  int bankEndian;		/* Module data written big endian */
+  int swapFile;			/* Whole file written in the other byte order */
+  unsigned int seed;
+} genConfig;
+
+static unsigned int genRandState;
+
+static unsigned int
+genRand()
+{
+  /* xorshift32 */
+  genRandState ^= genRandState << 13;
+  genRandState ^= genRandState >> 17;
+  genRandState ^= genRandState << 5;
+  return genRandState;
+}
+
+static inline unsigned int
+genWord(unsigned int word, int swap)
+{
+  return swap ? bswap_32(word) : word;
+}
+
+/* One module data bank: a block of events from each slot */
+static int
+genModuleBank(genConfig *cfg, unsigned int *buf, unsigned long long evnum)
+{
+  int nw = 0, islot, ievt, start, remaining, nsamples, iword;
+  int swap = cfg->bankEndian;
+  int blkNum = (int)((evnum / cfg->blockLevel) & 0x3FF);
+
+  for(islot = 0; islot < cfg->nslots; islot++)
+    {
+      int slot = GEN_FIRST_SLOT + islot;
+      start = nw;
+
+      buf[nw++] = genWord(0x80000000 | (slot << 22) | (MODID_FA250 << 18) |
+			  (blkNum << 8) | cfg->blockLevel, swap);
+
+      for(ievt = 0; ievt < cfg->blockLevel; ievt++)
+	{
+	  unsigned long long ts = (evnum + ievt) * 250ULL;
+
+	  buf[nw++] = genWord(0x90000000 | (slot << 22) |
+			      ((evnum + ievt) & 0x3FFFFF), swap);
+	  buf[nw++] = genWord(0x98000000 | (ts & 0xFFFFFF), swap);
+	  buf[nw++] = genWord((ts >> 24) & 0xFFFFFF, swap);
+
+	  /* Window raw data, one channel at a time */
+	  remaining = cfg->wordsPerEvent;
+	  while(remaining > 0)
+	    {
+	      int channel = genRand() & 0xF;
+
+	      nsamples = (remaining - 1 < GEN_SAMPLE_WORDS) ?
+		remaining - 1 : GEN_SAMPLE_WORDS;
+	      buf[nw++] = genWord(0xA0000000 | (channel << 23) | (2 * nsamples), swap);
+	      for(iword = 0; iword < nsamples; iword++)
+		{
+		  unsigned int r = genRand();
+		  buf[nw++] = genWord(((r & 0xFFF) << 16) | ((r >> 16) & 0xFFF), swap);
+		}
+	      remaining -= nsamples + 1;
+	    }
+	}
+
+      buf[nw] = genWord(0x88000000 | (slot << 22) | (nw - start + 1), swap);
+      nw++;
+
+      /* Fill to an even number of words */
+      if((nw - start) & 1)
+	buf[nw++] = genWord(0xF8000000 | (slot << 22), swap);
+    }
+
+  return nw;
+}
+
+/* One CODA 3 physics event (block of blockLevel triggers) */
+static int
+genEvent(genConfig *cfg, unsigned int *buf, unsigned long long evnum)
+{
+  int nw = 0, trig, iroc, ibank, ievt, nshort;
+
+  buf[nw++] = 0;
+  buf[nw++] = (GEN_PHYSICS_EVENT_TAG << 16) | (EVIO_BANK << 8) | cfg->blockLevel;
+
+  /* Trigger bank of segments */
+  trig = nw;
+  buf[nw++] = 0;
+  buf[nw++] = (GEN_TRIGGER_BANK_TAG << 16) | (EVIO_SEGMENT << 8) | cfg->nrocs;
+
+  /* First event number, and a timestamp for each event */
+  buf[nw++] = (EVIO_ULONG64 << 16) | (2 * (1 + cfg->blockLevel));
+  buf[nw++] = evnum & 0xFFFFFFFF;
+  buf[nw++] = evnum >> 32;
+  for(ievt = 0; ievt < cfg->blockLevel; ievt++)
+    {
+      unsigned long long ts = (evnum + ievt) * 250ULL;
+      buf[nw++] = ts & 0xFFFFFFFF;
+      buf[nw++] = ts >> 32;
+    }
+
+  /* Event types, padded to a whole word */
+  nshort = (cfg->blockLevel + 1) / 2;
+  buf[nw++] = ((cfg->blockLevel & 1) << 23) | (EVIO_USHORT16 << 16) | nshort;
+  memset(&buf[nw], 0, nshort * sizeof(unsigned int));
+  for(ievt = 0; ievt < cfg->blockLevel; ievt++)
+    ((unsigned short *)&buf[nw])[ievt] = 1 + (genRand() & 0x3);
+  nw += nshort;
+
+  for(iroc = 1; iroc <= cfg->nrocs; iroc++)
+    {
+      buf[nw++] = (iroc << 24) | (EVIO_UINT32 << 16) | GEN_ROC_SEGMENT_WORDS;
+      buf[nw++] = evnum & 0xFFFFFFFF;
+      buf[nw++] = genRand();
+    }
+  buf[trig] = nw - trig - 1;
+
+  /* ROC banks of module data banks */
+  for(iroc = 1; iroc <= cfg->nrocs; iroc++)
+    {
+      int roc = nw;
+      buf[nw++] = 0;
+      buf[nw++] = (iroc << 16) | (EVIO_BANK << 8) | cfg->blockLevel;
+
+      for(ibank = 0; ibank < cfg->nbanks; ibank++)
+	{
+	  int bank = nw;
+	  buf[nw++] = 0;
+	  buf[nw++] = ((GEN_FIRST_BANK_TAG + ibank) << 16) | (EVIO_UINT32 << 8);
+	  nw += genModuleBank(cfg, &buf[nw], evnum);
+	  buf[bank] = nw - bank - 1;
+	}
+      buf[roc] = nw - roc - 1;
+    }
+
+  buf[0] = nw - 1;
+
+  return nw;
+}
+
+/* Swap the contents of a native EVIO structure to the other byte order */
+static void
+genSwapData(unsigned int *data, int ndata, int type)
+{
+  int iword = 0, len, ctype, i;
+  unsigned int header, tmp;
+
+  switch(type)
+    {
+    case EVIO_BANK:
+    case EVIO_ALSOBANK:
+      while(iword + 2 <= ndata)
+	{
+	  len    = data[iword];
+	  header = data[iword + 1];
+	  ctype  = (header >> 8) & 0x3F;
+	  data[iword]     = bswap_32(len);
+	  data[iword + 1] = bswap_32(header);
+	  genSwapData(&data[iword + 2], len - 1, ctype);
+	  iword += len + 1;
+	}
+      break;
+
+    case EVIO_SEGMENT:
+    case EVIO_ALSOSEGMENT:
+      while(iword < ndata)
+	{
+	  header = data[iword];
+	  len    = header & 0xFFFF;
+	  data[iword] = bswap_32(header);
+	  genSwapData(&data[iword + 1], len, (header >> 16) & 0x3F);
+	  iword += len + 1;
+	}
+      break;
+
+    case EVIO_DOUBLE64:
+    case EVIO_LONG64:
+    case EVIO_ULONG64:
+      for(i = 0; i + 1 < ndata; i += 2)
+	{
+	  tmp         = bswap_32(data[i]);
+	  data[i]     = bswap_32(data[i + 1]);
+	  data[i + 1] = tmp;
+	}
+      break;
+
+    case EVIO_SHORT16:
+    case EVIO_USHORT16:
+      for(i = 0; i < 2 * ndata; i++)
+	((unsigned short *)data)[i] = bswap_16(((unsigned short *)data)[i]);
+      break;
+
+    default:
+      for(i = 0; i < ndata; i++)
+	data[i] = bswap_32(data[i]);
+    }
+}
+
+static int
+genWriteBlock(genConfig *cfg, FILE *out, unsigned int *block, int nwords,
+	      int blockNumber, int nevents, int last)
+{
+  unsigned int header[8];
+  int i;
+
+  header[0] = nwords + 8;
+  header[1] = blockNumber;
+  header[2] = 8;
+  header[3] = nevents;
+  header[4] = 0;
+  header[5] = EVIO_VERSION | (last ? EVIO_LAST_BLOCK_MASK : 0);
+  header[6] = 0;
+  header[7] = EVIO_MAGIC;
+
+  if(cfg->swapFile)
+    for(i = 0; i < 8; i++)
+      header[i] = bswap_32(header[i]);
+
+  if((fwrite(header, sizeof(unsigned int), 8, out) != 8) ||
+     (fwrite(block, sizeof(unsigned int), nwords, out) != (size_t)nwords))
+    {
+      perror("fwrite");
+      return ERROR;
+    }
+
+  return OK;
+}
+
+static void
+usage(const char *name)
+{
+  printf("usage: %s [options] <file>\n", name);
+  printf("  -n <events>   CODA events (blocks) to write      (default 1000)\n");
+  printf("  -r <rocs>     ROC banks per event                (default 4)\n");
+  printf("  -b <banks>    Module data banks per ROC          (default 2)\n");
+  printf("  -s <slots>    Slots per bank                     (default 16)\n");
+  printf("  -l <level>    Block level                        (default 40)\n");
+  printf("  -w <words>    Module data words per slot, event  (default 20)\n");
+  printf("  -e            Write module data big endian\n");
+  printf("  -x            Write the file in the other byte order\n");
+  printf("  -S <seed>     Random seed                        (default 1)\n");
+}
+
+int
+main(int argc, char **argv)
+{
+  genConfig cfg = { 1000, 4, 2, 16, 40, 20, 0, 0, 1 };
+  unsigned int *block;
+  unsigned long long evnum = 1, nwritten = 0;
+  int opt, ievent, nw = 0, nblock = 0, blockNumber = 1, maxEventWords;
+  FILE *out;
+
+  while((opt = getopt(argc, argv, "n:r:b:s:l:w:exS:h")) != -1)
+    {
+      switch(opt)
+	{
+	case 'n': cfg.nevents       = atoi(optarg); break;
+	case 'r': cfg.nrocs         = atoi(optarg); break;
+	case 'b': cfg.nbanks        = atoi(optarg); break;
+	case 's': cfg.nslots        = atoi(optarg); break;
+	case 'l': cfg.blockLevel    = atoi(optarg); break;
+	case 'w': cfg.wordsPerEvent = atoi(optarg); break;
+	case 'e': cfg.bankEndian    = 1; break;
+	case 'x': cfg.swapFile      = 1; break;
+	case 'S': cfg.seed          = strtoul(optarg, NULL, 0); break;
+	default:
+	  usage(argv[0]);
+	  exit(-1);
+	}
+    }
+
+  if((optind >= argc) || (cfg.nevents < 1) ||
+     (cfg.nrocs < 1) || (cfg.nrocs >= SIMPLE_MAX_ROCS) ||
+     (cfg.nbanks < 1) || (cfg.nbanks + GEN_FIRST_BANK_TAG > SIMPLE_MAX_BANKS) ||
+     (cfg.nslots < 1) || (cfg.nslots + GEN_FIRST_SLOT > SIMPLE_MAX_SLOTS) ||
+     (cfg.blockLevel < 1) || (cfg.blockLevel > SIMPLE_MAX_BLOCKLEVEL) ||
+     (cfg.wordsPerEvent < 2))
+    {
+      usage(argv[0]);
+      exit(-1);
+    }
+
+  genRandState = cfg.seed ? cfg.seed : 1;
+
+  /* Upper limit of the words in one CODA event */
+  maxEventWords = 16 + 2 * (cfg.blockLevel + 1) + cfg.blockLevel +
+    3 * cfg.nrocs + cfg.nrocs * (2 + cfg.nbanks * (2 + cfg.nslots *
+      (3 + cfg.blockLevel * (3 + 2 * cfg.wordsPerEvent))));
+
+  block = (unsigned int *) malloc((EVIO_BLOCK_MAX_WORDS + maxEventWords) * sizeof(unsigned int));
+  if(block == NULL)
+    {
+      printf("Unable to allocate %d words\n", EVIO_BLOCK_MAX_WORDS + maxEventWords);
+      exit(-1);
+    }
+
+  out = fopen(argv[optind], "w");
+  if(out == NULL)
+    {
+      perror(argv[optind]);
+      exit(-1);
+    }
+
+  for(ievent = 0; ievent < cfg.nevents; ievent++)
+    {
+      int evlen = genEvent(&cfg, &block[nw], evnum);
+
+      if(cfg.swapFile)
+	{
+	  unsigned int header = block[nw + 1];
+	  block[nw]     = bswap_32(block[nw]);
+	  block[nw + 1] = bswap_32(header);
+	  genSwapData(&block[nw + 2], evlen - 2, (header >> 8) & 0x3F);
+	}
+
+      nw += evlen;
+      nblock++;
+      nwritten += evlen;
+      evnum += cfg.blockLevel;
+
+      if((nw >= EVIO_BLOCK_MAX_WORDS) || (nblock >= EVIO_BLOCK_MAX_EVENTS) ||
+	 (ievent == cfg.nevents - 1))
+	{
+	  if(genWriteBlock(&cfg, out, block, nw, blockNumber++, nblock,
+			   ievent == cfg.nevents - 1) != OK)
+	    exit(-1);
+	  nw = 0;
+	  nblock = 0;
+	}
+    }
+
+  fclose(out);
+  free(block);
+
+  printf("%s: %d CODA events (%llu triggers), %llu words\n",
+	 argv[optind], cfg.nevents, evnum - 1, nwritten);
+
+  return 0;
+}
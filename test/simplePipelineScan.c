@@ -0,0 +1,90 @@
+/*
+ * File:
+ *    simplePipelineScan.c
+ *
+ * Description:
+ *    Index every event of an EVIO file with the simple event pipeline,
+ *    reading it with the memory mapped file reader,
+ *    and report events/s and words/s for 1 to N workers.
+ *
+ *    usage: simplePipelineScan <file> [max workers]
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include "simpleLib.h"
+
+/* Touch the index like a consumer would */
+static int
+checkEvent(void *arg, simplePipelineEvent *event)
+{
+  unsigned long long *expected = (unsigned long long *)arg;
+  unsigned long long *time;
+
+  if(event->seq != *expected)
+    {
+      printf("ERROR: Event %llu received, expected %llu\n", event->seq, *expected);
+      return ERROR;
+    }
+  (*expected)++;
+
+  if(event->isPhysics)
+    simpleCtxGetTriggerBankTimeSegment(event->ctx, &time);
+
+  return OK;
+}
+
+int
+main(int argc, char **argv)
+{
+  int nworkers, maxworkers = 4;
+  simpleFile *file;
+  char *filename;
+  simplePipeline *pipe;
+  simplePipelineStats stats;
+  unsigned long long expected;
+
+  if(argc < 2)
+    {
+      printf("usage: %s <file> [max workers]\n", argv[0]);
+      exit(-1);
+    }
+  filename = argv[1];
+  if(argc > 2)
+    maxworkers = atoi(argv[2]);
+
+  simpleInit();
+
+  printf("%8s %12s %14s %14s %10s\n",
+	 "workers", "events", "events/s", "words/s", "seconds");
+
+  for(nworkers = 1; nworkers <= maxworkers; nworkers++)
+    {
+      if((file = simpleFileOpen(filename)) == NULL)
+	{
+	  printf("Unable to open file %s\n", filename);
+	  exit(-1);
+	}
+
+      pipe = simplePipelineCreate(nworkers, 0, simpleFileRead, NULL, file);
+      if(pipe == NULL)
+	exit(-1);
+
+      expected = 0;
+      if(simplePipelineRun(pipe, checkEvent, &expected) != OK)
+	printf("ERROR: Pipeline stopped before the end of %s\n", filename);
+      simplePipelineGetStats(pipe, &stats);
+
+      printf("%8d %12llu %14.1f %14.1f %10.3f\n",
+	     stats.nworkers, stats.nevents, stats.eventRate, stats.wordRate,
+	     stats.seconds);
+
+      simplePipelineDestroy(pipe);
+      simpleFileClose(file);
+    }
+
+  return 0;
+}
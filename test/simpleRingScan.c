@@ -0,0 +1,245 @@
+/*
+ * File:
+ *    simpleRingScan.c
+ *
+ * Description:
+ *    Check the ring and stream scans against simpleScan().  Each physics
+ *    event of an EVIO file is copied into a ring of its own size, at
+ *    every start offset, and scanned there with simpleCtxScanRing().  It
+ *    is also fed to simpleCtxStreamFeed() in chunks of a few sizes.  The
+ *    index of each is compared with that of simpleCtxScan() of the event.
+ *
+ *    usage: simpleRingScan <file> [max events]
+ *
+ *    Every start offset is one scan, so keep the events small:
+ *      simpleGen -n 4 -r 2 -s 4 -l 4 ring.evio
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "simpleLib.h"
+
+static unsigned long long nchecks = 0, nwrapped = 0, nfailures = 0;
+
+#define FAIL(...)				\
+  do {						\
+    if(nfailures++ < 20)			\
+      printf("ERROR: " __VA_ARGS__);		\
+  } while(0)
+
+/* Span has the len words at data */
+static int
+spanEqual(const simpleSpan *span, const unsigned int *data, int len)
+{
+  if(span->length[0] + span->length[1] != len)
+    return 0;
+
+  if(span->length[1])
+    nwrapped++;
+
+  return (memcmp(span->data[0], data, span->length[0] * 4) == 0) &&
+    ((span->length[1] == 0) ||
+     (memcmp(span->data[1], &data[span->length[0]], span->length[1] * 4) == 0));
+}
+
+/* Compare the index of ctx with that of ref, from simpleCtxScan() */
+static void
+compareIndex(simpleCtx *ref, simpleCtx *ctx, const char *what, int offset)
+{
+  int rocList[SIMPLE_MAX_ROCS], rocList2[SIMPLE_MAX_ROCS];
+  int bankList[SIMPLE_MAX_BANKS], bankList2[SIMPLE_MAX_BANKS];
+  int nrocs, nbanks, iroc, ibank, islot, ievt, rocID, bankID, len, level, level2;
+  unsigned int slotmask, slotmask2, word, word2, *data;
+  simpleSpan span;
+
+  nrocs = simpleCtxGetRocList(ref, rocList);
+  if((simpleCtxGetRocList(ctx, rocList2) != nrocs) ||
+     (memcmp(rocList, rocList2, nrocs * sizeof(int)) != 0))
+    {
+      FAIL("%s %d: ROC list differs\n", what, offset);
+      return;
+    }
+
+  for(iroc = 0; iroc < nrocs; iroc++)
+    {
+      rocID = rocList[iroc];
+      nbanks = simpleCtxGetBankList(ref, rocID, bankList);
+      if((simpleCtxGetBankList(ctx, rocID, bankList2) != nbanks) ||
+	 (memcmp(bankList, bankList2, nbanks * sizeof(int)) != 0))
+	{
+	  FAIL("%s %d: bank list of ROC %d differs\n", what, offset, rocID);
+	  continue;
+	}
+
+      for(ibank = 0; ibank < nbanks; ibank++)
+	{
+	  bankID = bankList[ibank];
+	  if(simpleCtxGetRocSlotmask(ref, rocID, bankID, &slotmask) < 0)
+	    continue;
+
+	  simpleCtxGetRocBlockLevel(ref, rocID, bankID, &level);
+	  if((simpleCtxGetRocSlotmask(ctx, rocID, bankID, &slotmask2) < 0) ||
+	     (slotmask != slotmask2) ||
+	     (simpleCtxGetRocBlockLevel(ctx, rocID, bankID, &level2) < 0) ||
+	     (level != level2))
+	    {
+	      FAIL("%s %d: slots of ROC %d bank %d differ\n", what, offset, rocID, bankID);
+	      continue;
+	    }
+
+	  len = simpleCtxGetRocBankData(ref, rocID, bankID, &data);
+	  nchecks++;
+	  if((simpleCtxGetRocBankSpan(ctx, rocID, bankID, &span) != len) ||
+	     !spanEqual(&span, data, len))
+	    FAIL("%s %d: data of ROC %d bank %d differs\n", what, offset, rocID, bankID);
+
+	  for(islot = 0; islot < SIMPLE_MAX_SLOTS; islot++)
+	    {
+	      if((slotmask & (1u << islot)) == 0)
+		continue;
+
+	      simpleCtxGetSlotBlockHeader(ref, rocID, bankID, islot, &word);
+	      simpleCtxGetSlotBlockHeader(ctx, rocID, bankID, islot, &word2);
+	      if(word != word2)
+		FAIL("%s %d: block header of ROC %d bank %d slot %d differs\n",
+		     what, offset, rocID, bankID, islot);
+
+	      simpleCtxGetSlotBlockTrailer(ref, rocID, bankID, islot, &word);
+	      simpleCtxGetSlotBlockTrailer(ctx, rocID, bankID, islot, &word2);
+	      if(word != word2)
+		FAIL("%s %d: block trailer of ROC %d bank %d slot %d differs\n",
+		     what, offset, rocID, bankID, islot);
+
+	      for(ievt = 0; ievt < level; ievt++)
+		{
+		  len = simpleCtxGetSlotEventData(ref, rocID, bankID, islot, ievt, &data);
+		  if(len < 0)
+		    continue;
+
+		  nchecks++;
+		  if((simpleCtxGetSlotEventSpan(ctx, rocID, bankID, islot, ievt, &span) != len) ||
+		     !spanEqual(&span, data, len))
+		    FAIL("%s %d: event %d of ROC %d bank %d slot %d differs\n",
+			 what, offset, ievt, rocID, bankID, islot);
+		}
+	    }
+	}
+    }
+
+  if(simpleCtxGetNevents(ref) != simpleCtxGetNevents(ctx))
+    FAIL("%s %d: number of events differs\n", what, offset);
+}
+
+int
+main(int argc, char **argv)
+{
+  simpleFile *file;
+  simpleCtx *ref, *ctx;
+  unsigned int *data, *ring = NULL, *buffer = NULL;
+  char *filename;
+  int nwords, maxevents = 10, nevents = 0, size = 0, start, iword, status;
+  int ichunk, fed, chunk[] = { 1, 3, 64, 0 };	/* 0: the whole event */
+
+  if(argc < 2)
+    {
+      printf("usage: %s <file> [max events]\n", argv[0]);
+      exit(-1);
+    }
+  filename = argv[1];
+  if(argc > 2)
+    maxevents = atoi(argv[2]);
+
+  if((file = simpleFileOpen(filename)) == NULL)
+    {
+      printf("Unable to open file %s\n", filename);
+      exit(-1);
+    }
+
+  simpleInit();
+  simpleConfigErrorPrint(0);
+
+  ref = simpleCtxCreate();
+  ctx = simpleCtxCreate();
+  if((ref == NULL) || (ctx == NULL))
+    exit(-1);
+
+  while((nevents < maxevents) && (simpleFileRead(file, &data, &nwords) == OK))
+    {
+      /* Physics events */
+      if((nwords < 2) || ((data[1] >> 16) < 0xFF50) || ((data[1] >> 16) > 0xFF8F))
+	continue;
+      nevents++;
+
+      if(nwords > size)
+	{
+	  free(ring);
+	  free(buffer);
+	  size   = nwords;
+	  ring   = (unsigned int *) malloc(size * sizeof(unsigned int));
+	  buffer = (unsigned int *) malloc(size * sizeof(unsigned int));
+	  if((ring == NULL) || (buffer == NULL))
+	    exit(-1);
+	}
+
+      if(simpleCtxScan(ref, data, nwords) != OK)
+	{
+	  FAIL("simpleCtxScan failed for event %d\n", nevents);
+	  continue;
+	}
+
+      /* The event starting at every word of a ring of its size */
+      for(start = 0; start < nwords; start++)
+	{
+	  for(iword = 0; iword < nwords; iword++)
+	    ring[(start + iword) % nwords] = data[iword];
+
+	  if(simpleCtxScanRing(ctx, ring, nwords, start) != OK)
+	    FAIL("ring %d: simpleCtxScanRing failed for event %d\n", start, nevents);
+	  else
+	    compareIndex(ref, ctx, "ring", start);
+	}
+
+      /* The event arriving a chunk of words at a time */
+      for(ichunk = 0; ichunk < (int)(sizeof(chunk) / sizeof(chunk[0])); ichunk++)
+	{
+	  if(simpleCtxStreamStart(ctx, buffer, nwords) != OK)
+	    {
+	      FAIL("stream %d: simpleCtxStreamStart failed for event %d\n",
+		   chunk[ichunk], nevents);
+	      continue;
+	    }
+
+	  fed = 0;
+	  do
+	    {
+	      iword = chunk[ichunk] ? chunk[ichunk] : nwords;
+	      if(fed + iword > nwords)
+		iword = nwords - fed;
+	      memcpy(&buffer[fed], &data[fed], iword * sizeof(unsigned int));
+	      fed += iword;
+
+	      status = simpleCtxStreamFeed(ctx, fed, NULL);
+	    }
+	  while((status == SIMPLE_STREAM_MORE) && (fed < nwords));
+
+	  if(status != OK)
+	    FAIL("stream %d: simpleCtxStreamFeed returned %d for event %d\n",
+		 chunk[ichunk], status, nevents);
+	  else
+	    compareIndex(ref, ctx, "stream", chunk[ichunk]);
+	}
+    }
+
+  printf("%s: %d events, %llu checks, %llu wrapped, %llu failures\n",
+	 filename, nevents, nchecks, nwrapped, nfailures);
+
+  free(ring);
+  free(buffer);
+  simpleCtxDestroy(ref);
+  simpleCtxDestroy(ctx);
+  simpleFileClose(file);
+
+  return (nfailures == 0) ? 0 : -1;
+}
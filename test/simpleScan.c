@@ -3,41 +3,28 @@
 #include <string.h>
 #include <stdint.h>
 #include <byteswap.h>
-#include "evio.h"
 #include "simpleLib.h"
 
 int
 main(int argc, char **argv)
 {
   int verbose = 1;
-  int handle;
-  uint32_t *buf, bufLen, nevents = 0, status = 0;
+  simpleFile *file;
+  uint32_t *buf, nevents = 0;
+  int status = 0, nWords = 0;
   char filename[128] = "/home/moffit/tmp/vtpCompton_854.dat.0";
 
   simpleConfigSetDebug(0xffff & ~SIMPLE_SHOW_OTHER);
   /* Open file  */
-  if((status = evOpen((char *)filename,
-		      (char *) "r", &handle)) < 0)
+  if((file = simpleFileOpen(filename)) == NULL)
     {
-      printf("Unable to open file %s status = %d\n", filename, status);
+      printf("Unable to open file %s\n", filename);
       exit(-1);
     }
   else
     {
-      printf("Opened %s for reading (status = 0x%x, handle = %d)\n\n",
-	     filename, status, handle);
-    }
-
-  int version = 0;
-  /* Get evio version # of file */
-  status = evIoctl(handle, (char*)"v", &version);
-  if (status == S_SUCCESS)
-    {
-      printf("Evio file version = %d\n\n", version);
-    }
-  else
-    {
-      printf("status = 0x%x\n", status);
+      printf("Opened %s for reading (swapped = %d)\n\n",
+	     filename, simpleFileIsSwapped(file));
     }
 
   simpleInit();
@@ -48,11 +35,10 @@ main(int argc, char **argv)
   simpleConfigBank(3, 0x12, 20,
 		 1, 0, NULL);
 
-  while((status = evReadAlloc(handle, &buf, &bufLen)) == 0)
-    {				/* read the event and allocate the correct size buffer */
-      uint32_t nWords = 0, bt = 0, dt = 0, blk = 0;
+  while((status = simpleFileRead(file, &buf, &nWords)) == OK)
+    {				/* event points into the file mapping */
+      uint32_t bt = 0, dt = 0, blk = 0;
       int pe = 0;
-      nWords = buf[0] + 1;
       bt = ((buf[1] & 0xffff0000) >> 16);	/* Bank Tag */
       dt = ((buf[1] & 0xff00) >> 8);	/* Data Type */
       blk = buf[1] & 0xff;	/* Event Block size */
@@ -176,7 +162,7 @@ main(int argc, char **argv)
 	}
     }
 
-  if ( status == EOF )
+  if ( status == SIMPLE_FILE_EOF )
     {
       printf("Found end-of-file; total %d events. \n", nevents);
     }
@@ -185,6 +171,7 @@ main(int argc, char **argv)
       printf("Error reading file (status = 0x%x, quit)\n",status);
     }
 
+  simpleFileClose(file);
 
   return 0;
 }